@@ -5,13 +5,20 @@
 #ifndef STANDARDESE_COMMENT_HPP_INCLUDED
 #define STANDARDESE_COMMENT_HPP_INCLUDED
 
+#include <array>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "index.hpp"
 #include <standardese/comment/config.hpp>
 #include <standardese/comment/doc_comment.hpp>
 #include <standardese/comment/parser.hpp>
+#include <standardese/interned_string.hpp>
 #include <standardese/logger.hpp>
 
 namespace cppast
@@ -22,12 +29,20 @@ class cpp_file;
 
 namespace standardese
 {
+class entity_blacklist;
+class thread_pool;
+
 /// A registry of the comments for all entities.
 class comment_registry
 {
 public:
     /// \effects Registers everything from the other comment registry.
-    void merge(comment_registry&& other);
+    /// The members of a group in both registries are appended,
+    /// call [*sort_groups]() afterwards to get a deterministic order.
+    /// \notes The comments of an entity in both registries are merged like in
+    /// [*register_comment](),
+    /// a comment that cannot be merged is dropped and a warning is logged.
+    void merge(comment_registry&& other, const cppast::diagnostic_logger& logger);
 
     /// \effects Registers the comment for the given entity.
     /// \returns Whether or not a comment was registered already.
@@ -35,6 +50,12 @@ public:
     bool register_comment(type_safe::object_ref<const cppast::cpp_entity> entity,
                           comment::doc_comment                            comment);
 
+    /// \effects Removes the comment of the given entity, if there is one.
+    void unregister_comment(const cppast::cpp_entity& entity)
+    {
+        map_.erase(&entity);
+    }
+
     /// \effects Registers the comment for the given module.
     /// \returns Whether or not a comment was registered already.
     /// \notes It will not merge multiple comments.
@@ -49,24 +70,60 @@ public:
         const std::string& module_name) const;
 
     /// \effects Adds an entity to the group of the given name.
-    void add_to_group(std::string name, type_safe::object_ref<const cppast::cpp_entity> entity)
+    void add_to_group(const std::string& name,
+                      type_safe::object_ref<const cppast::cpp_entity> entity)
     {
-        groups_[std::move(name)].push_back(entity);
+        groups_[interned_string(name)].push_back(entity);
     }
 
+    /// \effects Sorts the members of every group by the name of their file
+    /// and their position in it,
+    /// so the order does not depend on the order the comments were registered in.
+    void sort_groups();
+
     /// \returns All the entities belonging to the given group.
     auto lookup_group(const std::string& name) const
         -> type_safe::array_ref<const type_safe::object_ref<const cppast::cpp_entity>>
     {
-        auto iter = groups_.find(name);
+        auto interned = interned_string::lookup(name);
+        if (!interned)
+            return nullptr;
+
+        auto iter = groups_.find(interned.value());
         if (iter == groups_.end())
             return nullptr;
         return type_safe::ref(iter->second.data(), iter->second.size());
     }
 
+    /// \effects Remembers the prefix of the unique names of the children of the given entity.
+    /// \notes The prefix depends on the comments of the entity and its parents,
+    /// so it must be forgotten if one of those changes.
+    void register_unique_name_prefix(const cppast::cpp_entity& e, std::string prefix)
+    {
+        prefixes_[&e] = std::move(prefix);
+    }
+
+    /// \effects Forgets the prefix of the unique names of the children of the given entity.
+    void forget_unique_name_prefix(const cppast::cpp_entity& e)
+    {
+        prefixes_.erase(&e);
+    }
+
+    /// \returns The remembered prefix of the unique names of the children of the entity, if any.
+    type_safe::optional_ref<const std::string> lookup_unique_name_prefix(
+        const cppast::cpp_entity& e) const
+    {
+        auto iter = prefixes_.find(&e);
+        if (iter == prefixes_.end())
+            return nullptr;
+        return type_safe::ref(iter->second);
+    }
+
 private:
     std::unordered_map<const cppast::cpp_entity*, comment::doc_comment> map_;
-    std::unordered_map<std::string, std::vector<type_safe::object_ref<const cppast::cpp_entity>>>
+    std::unordered_map<const cppast::cpp_entity*, std::string>          prefixes_;
+    std::unordered_map<interned_string,
+                       std::vector<type_safe::object_ref<const cppast::cpp_entity>>>
                                                           groups_;
     std::unordered_map<std::string, comment::doc_comment> modules_;
 };
@@ -78,51 +135,154 @@ std::string lookup_unique_name(const comment_registry& registry, const cppast::c
 class file_comment_parser
 {
 public:
+    /// \effects Creates a parser that parses the comments of all entities,
+    /// except for the ones that are always excluded by the `blacklist` and their children.
+    /// \requires The blacklist must live as long as the parser.
     explicit file_comment_parser(type_safe::object_ref<const cppast::diagnostic_logger> logger,
-                                 comment::config config = comment::config())
-    : config_(std::move(config)), logger_(logger)
-    {}
+                                 comment::config                                   config
+                                 = comment::config(),
+                                 type_safe::optional_ref<const entity_blacklist> blacklist
+                                 = nullptr);
+
+    ~file_comment_parser() noexcept;
 
     /// Parse all comments in `file`.
     /// \notes This function is thread-safe.
     void parse(type_safe::object_ref<const cppast::cpp_file> file) const;
 
     /// Create a registry from this parser.
+    /// \effects Connects the comments with an `\entity` command to their entities,
+    /// using jobs of the `pool`, if there is one.
     /// \returns The registry containing all registered comments.
     /// \requires This function must only be called once,
     /// and you must not call `parse()` afterwards.
-    comment_registry finish();
+    /// It must not be called from a job of the `pool`.
+    comment_registry finish(type_safe::optional_ref<thread_pool> pool = nullptr);
+
+    /// How often the result of parsing a comment could be reused.
+    struct cache_statistics
+    {
+        std::size_t comments; //< The number of comments parsed.
+        std::size_t reused;   //< The number of comments whose result was copied from the cache.
+    };
+
+    /// \returns The statistics of the cache of parsed comments.
+    /// \notes This function is thread-safe.
+    cache_statistics statistics() const noexcept;
 
 private:
+    class comment_cache;
+
+    static std::uint64_t next_id() noexcept;
+
+    /// \returns The result of parsing the comment text.
+    /// \requires The text must stay valid until [*finish]() is called.
+    /// \notes This function is thread-safe,
+    /// it reuses a [standardese::comment::parser]() per thread,
+    /// and the result of a previous comment with the same text,
+    /// once that text has been parsed twice.
+    comment::parse_result parse_comment(std::string_view text, bool has_matching_entity) const;
+
+    /// An uncommented entity that follows a sibling, and might be in the group of it.
+    struct implicit_group
+    {
+        const cppast::cpp_entity* target;
+        const cppast::cpp_entity* source;
+        /// The metadata of the comment of the target before it was grouped, if it had a comment.
+        type_safe::optional<comment::metadata> previous;
+        bool                                   grouped;
+    };
+
+    /// The number of partitions of the entities that can be documented by `\entity` comments.
+    static constexpr std::size_t no_partitions = 32u;
+
+    /// \returns The partition of the entities with the given unique name.
+    static std::size_t get_partition(const interned_string& unique_name) noexcept;
+
+    /// The uncommented entities and their unique names,
+    /// partitioned by the unique names so the partitions can be searched independently.
+    using uncommented_entities
+        = std::array<std::vector<std::pair<interned_string, const cppast::cpp_entity*>>,
+                     no_partitions>;
+
+    /// A comment with an `\entity` command and the unique name of its entity.
+    struct free_comment
+    {
+        interned_string       unique_name;
+        comment::parse_result comment;
+    };
+
+    /// The comments and uncommented entities registered by one thread,
+    /// merged into one after parsing.
+    struct tables
+    {
+        comment_registry     registry;
+        uncommented_entities uncommented;
+
+        // in the order the entities were visited
+        std::vector<implicit_group> implicit_groups;
+
+        // the unique names of the excluded entities whose comments weren't parsed
+        std::vector<std::string> pruned;
+    };
+
+    /// The comments of the entities of one partition that were documented by `\entity` comments.
+    struct resolved_comments
+    {
+        tables comments;
+        // the entities whose unique name changed
+        std::vector<const cppast::cpp_entity*> renamed;
+    };
+
     /// Connect free comments with an `\entity` command to their respective entities.
-    /// \notes This function is not thread-safe.
-    void resolve_free_comments();
+    /// \returns The comments of the entities in the given partition.
+    /// \notes This function is thread-safe for different partitions.
+    resolved_comments resolve_free_comments(std::size_t partition) const;
+
+    /// \returns Whether the entity with the given unique name, or one of its parents,
+    /// was excluded without parsing its comments.
+    bool is_pruned(const std::string& unique_name) const;
+
+    /// \effects Assigns `target` the group of its preceding sibling `source`,
+    /// if it is an uncommented entity that should be grouped implicitly.
+    /// It is only added to the list of members of the group by [*finish]().
+    /// \returns The grouping, if `target` can be grouped at all.
+    type_safe::optional<implicit_group> group_uncommented(tables&                   t,
+                                                          const cppast::cpp_entity& target,
+                                                          const cppast::cpp_entity* source) const;
 
-    /// Group uncommented entities with preceding commented entities.
+    /// \effects Removes the groups that were assigned implicitly,
+    /// so they can be assigned again once the `\entity` comments are resolved.
     /// \notes This function is not thread-safe.
-    void group_uncommented();
+    void ungroup_uncommented();
 
-    bool register_commented(type_safe::object_ref<const cppast::cpp_entity> entity,
+    /// \returns The tables of the calling thread.
+    /// \notes This function is thread-safe.
+    tables& thread_tables() const;
+
+    bool register_commented(tables& t, type_safe::object_ref<const cppast::cpp_entity> entity,
                             comment::doc_comment comment, bool allow_cmd = true) const;
 
-    void register_uncommented(type_safe::object_ref<const cppast::cpp_entity> entity) const;
+    void register_uncommented(tables&                                         t,
+                              type_safe::object_ref<const cppast::cpp_entity> entity) const;
 
-    type_safe::optional_ref<const comment::doc_comment> get_comment(
-        const cppast::cpp_entity& e) const
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return registry_.get_comment(e);
-    }
+    std::string get_parent_unique_name(const tables& t, const cppast::cpp_entity& e) const;
 
-    std::string get_parent_unique_name(const cppast::cpp_entity& e) const;
+    /// \effects Remembers the prefix of the unique names of the children of `e`,
+    /// so it doesn't need to be calculated from all parents for every child.
+    void register_unique_name_prefix(tables& t, const cppast::cpp_entity& e) const;
 
-    mutable std::mutex                                                      mutex_;
-    mutable std::unordered_multimap<std::string, const cppast::cpp_entity*> uncommented_;
-    mutable comment_registry                                                registry_;
-    mutable std::vector<comment::parse_result>                              free_comments_;
+    mutable std::mutex                                           mutex_;
+    mutable std::vector<std::unique_ptr<tables>>                 thread_tables_;
+    mutable tables                                               tables_; // only module comments
+    mutable std::array<std::vector<free_comment>, no_partitions> free_comments_;
+    std::unordered_set<std::string>                              pruned_;
 
     comment::config                                        config_;
+    type_safe::optional_ref<const entity_blacklist>        blacklist_;
     type_safe::object_ref<const cppast::diagnostic_logger> logger_;
+    std::uint64_t                                          id_;
+    std::unique_ptr<comment_cache>                         cache_;
 };
 } // namespace standardese
 
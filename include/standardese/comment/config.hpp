@@ -9,6 +9,7 @@
 #include <array>
 #include <string>
 #include <regex>
+#include <vector>
 
 #include <standardese/comment/commands.hpp>
 
@@ -48,6 +49,18 @@ namespace standardese::comment
         /// \returns The pattern that introduces a `cmd` inline.
         const std::regex& get_command_pattern(inline_type cmd) const;
 
+        /// \returns The literal text a match of the pattern of `cmd` starts with,
+        /// one for every alternative of the pattern.
+        /// An empty string means that a match can start with anything.
+        /// \group command_prefixes
+        const std::vector<std::string>& get_command_prefixes(command_type cmd) const;
+
+        /// \group command_prefixes
+        const std::vector<std::string>& get_command_prefixes(section_type cmd) const;
+
+        /// \group command_prefixes
+        const std::vector<std::string>& get_command_prefixes(inline_type cmd) const;
+
         /// \returns The name of a [*section_type]() in the resulting documentation.
         const char* inline_section_name(section_type section) const;
 
@@ -86,13 +99,20 @@ namespace standardese::comment
         /// \returns The default name of this command, i.e., the `name` in `\name`.
         static const char* command_name(inline_type cmd);
 
-        /// \returns The pattern obtained from the command line arguments `options`.
-        static std::regex command_pattern(const std::vector<std::string>& options);
+        /// \returns The patterns obtained from the command line arguments `options`.
+        static std::vector<std::string> command_patterns(const std::vector<std::string>& options);
+
+        /// \returns A regular expression matching any of the `patterns`.
+        static std::regex command_pattern(const std::vector<std::string>& patterns);
 
         std::vector<std::regex> special_command_patterns_;
         std::vector<std::regex> section_command_patterns_;
         std::vector<std::regex> inline_command_patterns_;
 
+        std::vector<std::vector<std::string>> special_command_prefixes_;
+        std::vector<std::vector<std::string>> section_command_prefixes_;
+        std::vector<std::vector<std::string>> inline_command_prefixes_;
+
         bool free_file_comments_;
         bool group_uncommented_;
     };
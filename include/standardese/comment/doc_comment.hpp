@@ -97,6 +97,9 @@ namespace comment
     /// `other.metadata()`, which aren't set in `data`.
     doc_comment merge(metadata data, doc_comment&& other);
 
+    /// \returns A copy of the comment.
+    doc_comment clone(const doc_comment& comment);
+
     /// \effects Adds a copy of the sections to the documentation builder.
     /// \group set_sections
     void set_sections(markup::entity_documentation::builder& builder, const doc_comment& comment);
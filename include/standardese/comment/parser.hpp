@@ -6,6 +6,7 @@
 #define STANDARDESE_COMMENT_PARSER_HPP_INCLUDED
 
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 
 #include <type_safe/optional.hpp>
@@ -32,6 +33,7 @@ namespace comment
     ///
     /// This is just a RAII wrapper over the `cmark_parser`
     /// and the [standardese::comment::config]().
+    /// It can be used to parse multiple comments, but only one at a time.
     class parser
     {
     public:
@@ -112,7 +114,8 @@ namespace comment
     /// Parses the comment.
     /// \returns The parsed comment.
     /// \throws [standardese::comment::parse_error]() if an error occurred.
-    parse_result parse(const parser& p, const std::string& comment, bool has_matching_entity);
+    /// \notes The text of the comment is not copied, it only needs to live during the call.
+    parse_result parse(const parser& p, std::string_view comment, bool has_matching_entity);
 } // namespace comment
 } // namespace standardese
 
@@ -722,6 +722,12 @@ public:
     bool is_blacklisted(const cppast::cpp_entity&         entity,
                         cppast::cpp_access_specifier_kind access) const;
 
+    /// \returns Whether or not the given entity is excluded no matter its comment,
+    /// i.e. it is blacklisted, an include guard or a `static_assert` that is not at class scope.
+    /// \notes Then neither its comment nor the comments of its children are needed.
+    bool is_always_excluded(const cppast::cpp_entity&         entity,
+                            cppast::cpp_access_specifier_kind access) const;
+
 private:
     std::unordered_set<std::string> ns_blacklist_;
     bool                            extract_private_;
@@ -38,6 +38,8 @@ class entity_index
 public:
     /// \effects Registers an entity and its documentation.
     /// Duplicate registration has no effect.
+    /// The brief is not copied unless it contains links,
+    /// so it must outlive the result of [*generate]().
     /// \requires The entity must not be a file or namespace and must be at namespace or global
     /// scope. The user data of the entity must be `nullptr` or the corresponding
     /// [standardese::doc_entity]. \notes This function is thread safe.
@@ -98,6 +100,8 @@ class file_index
 public:
     /// \effects Registers the given file and its documentation.
     /// Duplicate registration has no effect.
+    /// The brief is not copied unless it contains links,
+    /// so it must outlive the result of [*generate]().
     /// \notes This function is thread safe.
     void register_file(std::string link_name, std::string file_name,
                        type_safe::optional_ref<const markup::brief_section> brief) const;
@@ -132,6 +136,8 @@ public:
     void register_module(markup::module_documentation::builder doc) const;
 
     /// \effects Registers an entity for the given module.
+    /// The brief is not copied unless it contains links,
+    /// so it must outlive the result of [*generate]().
     /// \returns Whether or not there was a module already.
     /// If `false`, this function had no effect.
     /// \notes This function is thread safe.
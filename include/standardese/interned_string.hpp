@@ -0,0 +1,103 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_INTERNED_STRING_HPP_INCLUDED
+#define STANDARDESE_INTERNED_STRING_HPP_INCLUDED
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include <type_safe/optional.hpp>
+
+namespace standardese
+{
+/// \exclude
+namespace detail
+{
+    struct interned_entry
+    {
+        std::string   str;
+        std::uint32_t id;
+    };
+} // namespace detail
+
+/// A string that is stored only once in a global table.
+///
+/// Equal strings share the same storage and id,
+/// so they can be copied, compared and hashed in constant time.
+///
+/// The storage is never freed, not even when no `interned_string` refers to it anymore.
+/// A program that keeps running, like the tool in watch mode,
+/// keeps every string that was ever interned, e.g. the old names of renamed entities.
+class interned_string
+{
+public:
+    /// \effects Creates the empty string.
+    interned_string() noexcept : entry_(nullptr) {}
+
+    /// \effects Creates it from the given string, adding it to the table if necessary.
+    /// \notes This function is thread safe.
+    explicit interned_string(std::string_view str);
+
+    /// \returns The interned string equal to `str`, if it was added to the table before.
+    /// \notes This function is thread safe, it never adds a string to the table,
+    /// but it locks the part of the table the string would be in, like the constructor.
+    static type_safe::optional<interned_string> lookup(std::string_view str);
+
+    /// \returns Whether or not the string is empty.
+    bool empty() const noexcept
+    {
+        return entry_ == nullptr;
+    }
+
+    /// \returns The unique id of the string, the empty string has id `0`.
+    std::uint32_t id() const noexcept
+    {
+        return entry_ ? entry_->id : 0u;
+    }
+
+    /// \returns The string, it stays valid for the entire program.
+    const std::string& str() const noexcept;
+
+    /// \returns A view of the string, it stays valid for the entire program.
+    std::string_view view() const noexcept
+    {
+        return entry_ ? std::string_view(entry_->str) : std::string_view();
+    }
+
+private:
+    explicit interned_string(const detail::interned_entry* entry) noexcept : entry_(entry) {}
+
+    const detail::interned_entry* entry_;
+};
+
+/// \returns Whether or not two interned strings are (un-)equal.
+/// \group interned_string_equal interned_string comparison
+inline bool operator==(const interned_string& a, const interned_string& b) noexcept
+{
+    return a.id() == b.id();
+}
+
+/// \group interned_string_equal
+inline bool operator!=(const interned_string& a, const interned_string& b) noexcept
+{
+    return !(a == b);
+}
+} // namespace standardese
+
+namespace std
+{
+template <>
+struct hash<standardese::interned_string>
+{
+    std::size_t operator()(const standardese::interned_string& str) const noexcept
+    {
+        return std::hash<std::uint32_t>{}(str.id());
+    }
+};
+} // namespace std
+
+#endif // STANDARDESE_INTERNED_STRING_HPP_INCLUDED
@@ -12,6 +12,7 @@
 
 #include <type_safe/variant.hpp>
 
+#include <standardese/interned_string.hpp>
 #include <standardese/markup/link.hpp>
 
 namespace cppast
@@ -50,8 +51,8 @@ public:
                              std::string                                       link_name) const;
 
 private:
-    mutable std::mutex                                               mutex_;
-    mutable std::unordered_map<std::string, markup::block_reference> map_;
+    mutable std::mutex                                                   mutex_;
+    mutable std::unordered_map<interned_string, markup::block_reference> map_;
 
     std::map<std::string, std::string> external_doc_;
 };
@@ -66,8 +67,12 @@ void register_documentations(const cppast::diagnostic_logger& logger, const link
 /// Resolves all unresolved links in a document.
 /// \effects For all [standardese::markup::documentation_link]() entities that are not yet resolved,
 /// uses the linker to resolve them.
-/// \notes This function is *not* thread safe and must be called after the linker is entirely
-/// populated.
+/// \requires The linker must be entirely populated,
+/// and no other thread may resolve the links of the same document at the same time.
+/// \notes It modifies the links of the document, but only reads the linker,
+/// so the links of different documents can be resolved concurrently.
+/// No link is shared between documents:
+/// the indices only borrow briefs from the comments if they don't contain links.
 void resolve_links(const cppast::diagnostic_logger& logger, const linker& l,
                    const markup::document_entity& document);
 } // namespace standardese
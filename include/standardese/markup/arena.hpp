@@ -0,0 +1,51 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_MARKUP_ARENA_HPP_INCLUDED
+#define STANDARDESE_MARKUP_ARENA_HPP_INCLUDED
+
+#include <cstddef>
+
+namespace standardese
+{
+namespace markup
+{
+    /// \exclude
+    namespace detail
+    {
+        class node_arena;
+
+        /// \returns Memory for an entity of the given size.
+        /// It is taken from the arena of the current thread, if there is any,
+        /// and from the heap otherwise.
+        void* allocate_node(std::size_t size);
+
+        /// \effects Releases memory returned by [standardese::markup::detail::allocate_node]().
+        /// Memory of an arena is only given back once all entities allocated in it are destroyed.
+        void deallocate_node(void* memory) noexcept;
+
+        /// Creates a new arena and makes it the arena of the current thread,
+        /// until it is destroyed.
+        ///
+        /// All entities created in the meantime share the arena.
+        /// It is released in one go once the last of them is destroyed.
+        class arena_scope
+        {
+        public:
+            arena_scope();
+
+            arena_scope(const arena_scope&) = delete;
+            arena_scope& operator=(const arena_scope&) = delete;
+
+            ~arena_scope() noexcept;
+
+        private:
+            node_arena* arena_;
+            node_arena* previous_;
+        };
+    } // namespace detail
+} // namespace markup
+} // namespace standardese
+
+#endif // STANDARDESE_MARKUP_ARENA_HPP_INCLUDED
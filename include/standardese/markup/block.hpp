@@ -7,6 +7,7 @@
 
 #include <type_safe/optional.hpp>
 
+#include <standardese/interned_string.hpp>
 #include <standardese/markup/entity.hpp>
 
 namespace standardese
@@ -66,7 +67,7 @@ namespace markup
         explicit block_id() : block_id("") {}
 
         /// \effects Creates it given the string representation.
-        explicit block_id(std::string id) : id_(std::move(id)) {}
+        explicit block_id(std::string_view id) : id_(id) {}
 
         /// \returns Whether or not the id is empty.
         bool empty() const noexcept
@@ -77,21 +78,28 @@ namespace markup
         /// \returns The string representation of the id.
         const std::string& as_str() const noexcept
         {
-            return id_;
+            return id_.str();
         }
 
         /// \returns The escaped string representaton.
         std::string as_output_str() const;
 
+        /// \returns The interned string representation,
+        /// it allows comparing and hashing the id in constant time.
+        const interned_string& as_interned() const noexcept
+        {
+            return id_;
+        }
+
     private:
-        std::string id_;
+        interned_string id_;
     };
 
     /// \returns Whether or not two ids are (un-)equal.
     /// \group block_id_equal block_id comparison
     inline bool operator==(const block_id& a, const block_id& b) noexcept
     {
-        return a.as_str() == b.as_str();
+        return a.as_interned() == b.as_interned();
     }
 
     /// \group block_id_equal
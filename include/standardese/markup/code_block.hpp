@@ -5,6 +5,11 @@
 #ifndef STANDARDESE_MARKUP_CODE_BLOCK_HPP_INCLUDED
 #define STANDARDESE_MARKUP_CODE_BLOCK_HPP_INCLUDED
 
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
 #include <standardese/markup/block.hpp>
 #include <standardese/markup/phrasing.hpp>
 
@@ -112,6 +117,104 @@ namespace markup
         /// \group code_block_entity
         using preprocessor = code_block_entity<preprocessor_tag>;
 
+        /// A run of plain text, soft breaks and syntax highlighted tokens stored in one string.
+        ///
+        /// It is rendered the same way as the equivalent sequence of [standardese::markup::text](),
+        /// [standardese::markup::soft_break]() and code block entities,
+        /// but it is only a single entity and adjacent plain text is merged.
+        ///
+        /// \notes This entity is only meant to be used in a code block.
+        class token_sequence final : public phrasing_entity
+        {
+        public:
+            /// A single token of the sequence.
+            struct token
+            {
+                /// Either [standardese::markup::entity_kind::text](),
+                /// [standardese::markup::entity_kind::soft_break]()
+                /// or the kind of one of the code block syntax highlighting entities.
+                entity_kind      kind;
+                std::string_view string;
+            };
+
+            /// Builds a token sequence.
+            class builder
+            {
+            public:
+                /// \effects Creates an empty sequence.
+                builder() : result_(new token_sequence()) {}
+
+                /// \effects Adds plain text, merging it with preceding plain text.
+                builder& add_text(std::string_view text);
+
+                /// \effects Adds a soft break.
+                builder& add_soft_break();
+
+                /// \effects Adds a syntax highlighted token.
+                /// \requires `kind` must be the kind of one of the code block syntax highlighting
+                /// entities.
+                builder& add_token(entity_kind kind, std::string_view text);
+
+                /// \returns Whether or not the sequence is empty.
+                bool empty() const noexcept
+                {
+                    return result_->tokens_.empty();
+                }
+
+                /// \returns The finished sequence.
+                /// \effects Starts a new, empty sequence.
+                std::unique_ptr<token_sequence> finish()
+                {
+                    std::unique_ptr<token_sequence> next(new token_sequence());
+                    return std::exchange(result_, std::move(next));
+                }
+
+            private:
+                std::unique_ptr<token_sequence> result_;
+            };
+
+            /// \returns The text of all tokens, with a newline for every soft break.
+            const std::string& string() const noexcept
+            {
+                return text_;
+            }
+
+            /// \returns The number of tokens.
+            std::size_t size() const noexcept
+            {
+                return tokens_.size();
+            }
+
+            /// \returns The token at the given index.
+            /// \requires `i < size()`.
+            token operator[](std::size_t i) const noexcept
+            {
+                auto begin = i == 0u ? 0u : tokens_[i - 1u].end;
+                return token{tokens_[i].kind,
+                             std::string_view(text_).substr(begin, tokens_[i].end - begin)};
+            }
+
+        private:
+            token_sequence() noexcept = default;
+
+            entity_kind do_get_kind() const noexcept override;
+
+            void do_visit(detail::visitor_callback_t cb, void* mem) const override;
+
+            std::unique_ptr<entity> do_clone() const override;
+
+            void append(entity_kind kind, std::string_view text);
+
+            struct token_end
+            {
+                entity_kind   kind;
+                std::uint32_t end;
+            };
+
+            std::string            text_;
+            std::vector<token_end> tokens_;
+        };
+
         /// Builds a code block.
         class builder : public container_builder<code_block>
         {
@@ -9,6 +9,7 @@
 
 #include <type_safe/optional_ref.hpp>
 
+#include <standardese/markup/arena.hpp>
 #include <standardese/markup/block.hpp>
 #include <standardese/markup/entity.hpp>
 
@@ -19,6 +20,9 @@ namespace markup
     /// Base class for entities representing a stand-alone document.
     ///
     /// Those are the root nodes of the markup AST.
+    /// While the builder of a document exists,
+    /// all entities created on its thread are allocated in an arena belonging to the document.
+    /// It is released in one go once the document and all of them are destroyed.
     class document_entity : public entity, public container_entity<block_entity>
     {
     public:
@@ -51,7 +55,7 @@ namespace markup
     {
     public:
         /// Builds the main document.
-        class builder : public container_builder<main_document>
+        class builder : detail::arena_scope, public container_builder<main_document>
         {
         public:
             /// \effects Creates an empty document with given title and output file name.
@@ -78,7 +82,7 @@ namespace markup
     {
     public:
         /// Builds the sub document.
-        class builder : public container_builder<subdocument>
+        class builder : detail::arena_scope, public container_builder<subdocument>
         {
         public:
             /// \effects Creates an empty document with given title and output file name.
@@ -104,7 +108,7 @@ namespace markup
     {
     public:
         /// Builds a template document.
-        class builder : public container_builder<template_document>
+        class builder : detail::arena_scope, public container_builder<template_document>
         {
         public:
             /// \effects Creates it given the title and the file name of the template file.
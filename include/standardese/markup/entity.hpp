@@ -12,6 +12,7 @@
 
 #include <type_safe/optional_ref.hpp>
 
+#include <standardese/markup/arena.hpp>
 #include <standardese/markup/visitor.hpp>
 
 namespace standardese
@@ -55,6 +56,19 @@ namespace markup
             return do_clone();
         }
 
+        /// Entities are allocated from the arena of the document currently being built, if any.
+        /// \group allocation
+        static void* operator new(std::size_t size)
+        {
+            return detail::allocate_node(size);
+        }
+
+        /// \group allocation
+        static void operator delete(void* memory) noexcept
+        {
+            detail::deallocate_node(memory);
+        }
+
     protected:
         entity() noexcept = default;
 
@@ -5,6 +5,9 @@
 #ifndef STANDARDESE_MARKUP_ENTITY_KIND_HPP_INCLUDED
 #define STANDARDESE_MARKUP_ENTITY_KIND_HPP_INCLUDED
 
+#include <cstdint>
+#include <initializer_list>
+
 namespace standardese
 {
 namespace markup
@@ -51,6 +54,7 @@ namespace markup
         code_block_float_literal,
         code_block_punctuation,
         code_block_preprocessor,
+        code_block_token_sequence,
 
         brief_section,
         details_section,
@@ -67,6 +71,7 @@ namespace markup
 
         soft_break,
         hard_break,
+        borrowed_phrasing,
 
         external_link,
         documentation_link,
@@ -83,6 +88,61 @@ namespace markup
     /// \returns Whether or not the entity is a documentation,
     /// that is, derived from [standardese::markup::documentation_entity]().
     bool is_documentation(entity_kind kind) noexcept;
+
+    /// A set of [standardese::markup::entity_kind]()s.
+    class entity_kind_set
+    {
+    public:
+        /// \effects Creates an empty set.
+        constexpr entity_kind_set() noexcept : bits_(0u) {}
+
+        /// \effects Creates a set containing the given kinds.
+        constexpr entity_kind_set(std::initializer_list<entity_kind> kinds) noexcept : bits_(0u)
+        {
+            for (auto kind : kinds)
+                bits_ |= bit(kind);
+        }
+
+        /// \returns A set containing all kinds.
+        static constexpr entity_kind_set all() noexcept
+        {
+            return entity_kind_set(~std::uint64_t(0u));
+        }
+
+        /// \effects Adds the given kind.
+        constexpr void insert(entity_kind kind) noexcept
+        {
+            bits_ |= bit(kind);
+        }
+
+        /// \returns Whether or not the set contains the given kind.
+        constexpr bool contains(entity_kind kind) const noexcept
+        {
+            return (bits_ & bit(kind)) != 0u;
+        }
+
+        /// \returns Whether or not the two sets have a kind in common.
+        constexpr bool intersects(const entity_kind_set& other) const noexcept
+        {
+            return (bits_ & other.bits_) != 0u;
+        }
+
+    private:
+        explicit constexpr entity_kind_set(std::uint64_t bits) noexcept : bits_(bits) {}
+
+        static constexpr std::uint64_t bit(entity_kind kind) noexcept
+        {
+            return std::uint64_t(1u) << static_cast<unsigned>(kind);
+        }
+
+        std::uint64_t bits_;
+    };
+
+    /// \returns The kinds of entities that can be a direct or indirect child of an entity of the
+    /// given kind.
+    /// \notes The result depends only on the types of the children,
+    /// so it can contain kinds that never appear in practice.
+    entity_kind_set get_descendant_kinds(entity_kind kind) noexcept;
 } // namespace markup
 } // namespace standardese
 
@@ -9,6 +9,8 @@
 #include <iosfwd>
 #include <string>
 
+#include <standardese/markup/output_buffer.hpp>
+
 namespace standardese
 {
 namespace markup
@@ -17,13 +19,18 @@ namespace markup
 
     /// A generator.
     ///
-    /// It will write the entity representation to the given stream.
-    using generator = std::function<void(std::ostream&, const entity&)>;
+    /// It will append the entity representation to the given buffer.
+    using generator = std::function<void(output_buffer&, const entity&)>;
 
     /// Renders an entity to a string.
     ///
     /// \returns The string representation of the entity in the given format.
-    std::string render(generator gen, const entity& e);
+    std::string render(const generator& gen, const entity& e);
+
+    /// Renders an entity to a stream.
+    ///
+    /// \effects Renders the entity into a buffer and writes it to the stream in one go.
+    void render(const generator& gen, std::ostream& out, const entity& e);
 
     /// An HTML generator.
     ///
@@ -0,0 +1,97 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_MARKUP_OUTPUT_BUFFER_HPP_INCLUDED
+#define STANDARDESE_MARKUP_OUTPUT_BUFFER_HPP_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace standardese
+{
+namespace markup
+{
+    /// The output sink of a [standardese::markup::generator]().
+    ///
+    /// It is an append-only buffer that grows as needed.
+    class output_buffer
+    {
+    public:
+        /// \effects Creates an empty buffer that has room for at least `capacity` characters.
+        explicit output_buffer(std::size_t capacity = 0u)
+        {
+            reserve(capacity);
+        }
+
+        /// \effects Makes room for at least `capacity` characters in total.
+        void reserve(std::size_t capacity)
+        {
+            str_.reserve(capacity);
+        }
+
+        /// \effects Appends the given characters.
+        /// \group append
+        void append(std::string_view str)
+        {
+            str_.append(str.data(), str.size());
+        }
+
+        /// \group append
+        void append(char c)
+        {
+            str_.push_back(c);
+        }
+
+        /// \effects Same as `append(str)`.
+        /// \returns `*this`.
+        /// \group append_op
+        output_buffer& operator<<(std::string_view str)
+        {
+            append(str);
+            return *this;
+        }
+
+        /// \group append_op
+        output_buffer& operator<<(char c)
+        {
+            append(c);
+            return *this;
+        }
+
+        /// \effects Removes all characters but keeps the capacity,
+        /// so the buffer can be reused for the next output.
+        void clear() noexcept
+        {
+            str_.clear();
+        }
+
+        /// \returns The characters appended so far.
+        std::string_view view() const noexcept
+        {
+            return str_;
+        }
+
+        /// \returns The number of characters appended so far.
+        std::size_t size() const noexcept
+        {
+            return str_.size();
+        }
+
+        /// \returns The characters appended so far, moved out of the buffer.
+        /// The buffer is empty afterwards.
+        std::string release() noexcept
+        {
+            auto result = std::move(str_);
+            str_.clear();
+            return result;
+        }
+
+    private:
+        std::string str_;
+    };
+} // namespace markup
+} // namespace standardese
+
+#endif // STANDARDESE_MARKUP_OUTPUT_BUFFER_HPP_INCLUDED
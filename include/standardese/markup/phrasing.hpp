@@ -211,6 +211,49 @@ namespace markup
 
         hard_break() noexcept = default;
     };
+
+    /// Phrasing that is owned by another entity.
+    ///
+    /// It is rendered as if the children of the other entity were its own children,
+    /// so the same phrasing can appear in multiple documents without being copied.
+    /// \requires The other entity must outlive it and must not change while it is used.
+    /// \notes The parent of the children is still the other entity.
+    class borrowed_phrasing final : public phrasing_entity
+    {
+    public:
+        using iterator = container_entity<phrasing_entity>::iterator;
+
+        /// \returns A new entity borrowing all children of the given container.
+        static std::unique_ptr<borrowed_phrasing> build(
+            const container_entity<phrasing_entity>& container)
+        {
+            return std::unique_ptr<borrowed_phrasing>(
+                new borrowed_phrasing(container.begin(), container.end()));
+        }
+
+        /// \returns An iterator to the first borrowed entity.
+        iterator begin() const noexcept
+        {
+            return begin_;
+        }
+
+        /// \returns An iterator one past the last borrowed entity.
+        iterator end() const noexcept
+        {
+            return end_;
+        }
+
+    private:
+        entity_kind do_get_kind() const noexcept override;
+
+        void do_visit(detail::visitor_callback_t cb, void* mem) const override;
+
+        std::unique_ptr<entity> do_clone() const override;
+
+        borrowed_phrasing(iterator begin, iterator end) noexcept : begin_(begin), end_(end) {}
+
+        iterator begin_, end_;
+    };
 } // namespace markup
 } // namespace standardese
 
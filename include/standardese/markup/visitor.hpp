@@ -5,6 +5,10 @@
 #ifndef STANDARDESE_MARKUP_VISITOR_HPP_INCLUDED
 #define STANDARDESE_MARKUP_VISITOR_HPP_INCLUDED
 
+#include <type_traits>
+
+#include <standardese/markup/entity_kind.hpp>
+
 namespace standardese
 {
 namespace markup
@@ -24,6 +28,24 @@ namespace markup
             func(e);
             call_visit(e, &visitor_callback<Func>, mem);
         }
+
+        using filtered_visitor_callback_t = bool (*)(void* mem, const entity&);
+
+        bool visit_filtered(const entity& e, const entity_kind_set& kinds,
+                            filtered_visitor_callback_t cb, void* mem);
+
+        template <typename Func>
+        bool filtered_visitor_callback(void* mem, const entity& e)
+        {
+            auto& func = *static_cast<Func*>(mem);
+            if constexpr (std::is_void_v<decltype(func(e))>)
+            {
+                func(e);
+                return true;
+            }
+            else
+                return static_cast<bool>(func(e));
+        }
     } // namespace detail
 
     /// Visits an entity.
@@ -34,6 +56,20 @@ namespace markup
     {
         detail::visitor_callback<Func>(&f, e);
     }
+
+    /// Visits all entities of the given kinds.
+    /// \effects Invokes the function passing it the current entity, followed by all its children,
+    /// recursively, like [standardese::markup::visit](), but only for entities whose kind is in
+    /// `kinds`. The children of an entity that cannot contain any of the kinds are skipped.
+    /// If the function returns `false`, no further entities are visited.
+    /// \returns `false` if the visit was stopped by the function, `true` otherwise.
+    /// \notes The tree is traversed with an explicit stack, so deep documents don't lead to deep
+    /// recursion.
+    template <typename Func>
+    bool visit(const entity& e, const entity_kind_set& kinds, Func f)
+    {
+        return detail::visit_filtered(e, kinds, &detail::filtered_visitor_callback<Func>, &f);
+    }
 } // namespace markup
 } // namespace standardese
 
@@ -0,0 +1,101 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_THREAD_POOL_HPP_INCLUDED
+#define STANDARDESE_THREAD_POOL_HPP_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <type_safe/optional_ref.hpp>
+
+namespace standardese
+{
+/// A work-stealing thread pool that starts expensive jobs first.
+///
+/// Jobs added from outside the pool are ordered by their estimated cost.
+/// Jobs added by a worker go to its local queue, idle workers steal from the other queues.
+class thread_pool
+{
+public:
+    /// \returns The number of hardware threads, but at least one.
+    static unsigned default_no_threads() noexcept;
+
+    /// \returns The pool the calling thread is a worker of, if any.
+    static type_safe::optional_ref<thread_pool> current() noexcept;
+
+    /// \effects Starts the given number of worker threads, but at least one.
+    explicit thread_pool(unsigned no_threads);
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /// \effects Finishes all jobs and joins the worker threads.
+    ~thread_pool() noexcept;
+
+    /// \effects Schedules the job `f`.
+    /// Jobs with a higher `cost` are started before jobs with a lower one.
+    /// \returns A future for the result of the job.
+    /// \notes This function is thread safe.
+    /// A worker can add nested jobs, but it must not wait for their futures:
+    /// a waiting worker does not run other jobs, so the pool can deadlock.
+    template <typename Fnc>
+    auto add_job(Fnc f, double cost = 0.) -> std::future<std::invoke_result_t<Fnc>>
+    {
+        using result = std::invoke_result_t<Fnc>;
+
+        auto task   = std::make_shared<std::packaged_task<result()>>(std::move(f));
+        auto future = task->get_future();
+        push(job{[task] { (*task)(); }, cost, 0u});
+        return future;
+    }
+
+    /// \returns The number of worker threads.
+    unsigned size() const noexcept
+    {
+        return static_cast<unsigned>(workers_.size());
+    }
+
+private:
+    struct job
+    {
+        std::function<void()> f;
+        double                cost;
+        std::uint64_t         sequence;
+    };
+
+    struct queue
+    {
+        std::mutex      mutex;
+        std::deque<job> jobs;
+    };
+
+    void push(job j);
+    bool pop(std::size_t worker, job& j);
+    void run(std::size_t worker);
+
+    std::vector<std::unique_ptr<queue>> local_;
+    std::mutex                          global_mutex_;
+    std::vector<job>                    global_; // heap ordered by cost
+    std::uint64_t                       sequence_;
+
+    std::mutex              wait_mutex_;
+    std::condition_variable wait_cv_;
+    std::atomic<long>       no_queued_;
+    bool                    stop_;
+
+    std::vector<std::thread> workers_;
+};
+} // namespace standardese
+
+#endif // STANDARDESE_THREAD_POOL_HPP_INCLUDED
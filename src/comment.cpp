@@ -4,11 +4,21 @@
 
 #include <cassert>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <stack>
+#include <string_view>
 
 #include <standardese/comment.hpp>
+#include <standardese/doc_entity.hpp>
+#include <standardese/thread_pool.hpp>
 
+#include <cppast/cpp_file.hpp>
 #include <cppast/cpp_friend.hpp>
 #include <cppast/cpp_namespace.hpp>
 #include <cppast/visitor.hpp>
@@ -17,14 +27,80 @@
 
 using namespace standardese;
 
-void comment_registry::merge(comment_registry&& other)
+void comment_registry::merge(comment_registry&& other, const cppast::diagnostic_logger& logger)
 {
-    map_.insert(std::make_move_iterator(other.map_.begin()),
-                std::make_move_iterator(other.map_.end()));
-    groups_.insert(std::make_move_iterator(other.groups_.begin()),
-                   std::make_move_iterator(other.groups_.end()));
-    modules_.insert(std::make_move_iterator(other.modules_.begin()),
-                    std::make_move_iterator(other.modules_.end()));
+    for (auto& entry : other.map_)
+        if (!register_comment(type_safe::ref(*entry.first), std::move(entry.second)))
+            logger.log("standardese comment",
+                       make_diagnostic(cppast::source_location::make_entity(entry.first->name()),
+                                       "multiple comments for entity '", entry.first->name(),
+                                       "'"));
+    for (auto& group : other.groups_)
+    {
+        auto& entities = groups_[group.first];
+        entities.insert(entities.end(), group.second.begin(), group.second.end());
+    }
+    for (auto& module : other.modules_)
+        if (!register_comment(module.first, std::move(module.second)))
+            logger.log("standardese comment",
+                       make_diagnostic(cppast::source_location::make_entity(module.first),
+                                       "multiple comments for module '", module.first, "'"));
+    prefixes_.insert(std::make_move_iterator(other.prefixes_.begin()),
+                     std::make_move_iterator(other.prefixes_.end()));
+}
+
+namespace
+{
+const cppast::cpp_file& get_file(const cppast::cpp_entity& e)
+{
+    auto cur = &e;
+    while (cur->parent())
+        cur = &cur->parent().value();
+    assert(cur->kind() == cppast::cpp_entity_kind::file_t);
+    return static_cast<const cppast::cpp_file&>(*cur);
+}
+} // namespace
+
+void comment_registry::sort_groups()
+{
+    // the position of the entities in the files with group members
+    std::unordered_map<const cppast::cpp_entity*, std::size_t> positions;
+    std::unordered_set<const cppast::cpp_file*>                files;
+    for (auto& group : groups_)
+        for (auto& member : group.second)
+        {
+            auto& file = get_file(*member);
+            if (!files.insert(&file).second)
+                continue;
+
+            auto position = std::size_t(0);
+            cppast::visit(file, [&](const cppast::cpp_entity& e, const cppast::visitor_info& info) {
+                if (info.event != cppast::visitor_info::container_entity_exit)
+                    positions.emplace(&e, position++);
+                return true;
+            });
+        }
+
+    auto get_position = [&](const cppast::cpp_entity& e) {
+        // parameters aren't visited, they get the position of their parent
+        for (auto cur = &e;; cur = &cur->parent().value())
+        {
+            auto iter = positions.find(cur);
+            if (iter != positions.end())
+                return iter->second;
+        }
+    };
+
+    for (auto& group : groups_)
+        std::stable_sort(group.second.begin(), group.second.end(),
+                         [&](type_safe::object_ref<const cppast::cpp_entity> lhs,
+                             type_safe::object_ref<const cppast::cpp_entity> rhs) {
+                             auto& lhs_file = get_file(*lhs).name();
+                             auto& rhs_file = get_file(*rhs).name();
+                             if (lhs_file != rhs_file)
+                                 return lhs_file < rhs_file;
+                             return get_position(*lhs) < get_position(*rhs);
+                         });
 }
 
 bool comment_registry::register_comment(type_safe::object_ref<const cppast::cpp_entity> entity,
@@ -177,30 +253,229 @@ void process_inlines(const cppast::diagnostic_logger&            logger,
 }
 } // namespace
 
+namespace
+{
+comment::parse_result clone(const comment::parse_result& result)
+{
+    std::vector<comment::unmatched_doc_comment> inlines;
+    inlines.reserve(result.inlines.size());
+    for (auto& inline_comment : result.inlines)
+        inlines.emplace_back(inline_comment.entity, comment::clone(inline_comment.comment));
+
+    auto doc = result.comment.map([](const comment::doc_comment& c) { return comment::clone(c); });
+    return comment::parse_result{std::move(doc), result.entity, std::move(inlines)};
+}
+} // namespace
+
+// Caches the results of parsing comments by their text.
+// The config is the same for all comments of a parser, so it is not part of the key.
+// Identical comments are common, e.g. for overloads, so they are only parsed once or twice.
+// The texts are owned by the parsed files, which outlive the cache, so they aren't copied.
+class file_comment_parser::comment_cache
+{
+public:
+    type_safe::optional<comment::parse_result> lookup(std::string_view text,
+                                                      bool             has_matching_entity)
+    {
+        ++comments_;
+
+        auto& shard = get_shard(text);
+        const comment::parse_result* result = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto& results = shard.results[has_matching_entity];
+            auto  iter    = results.find(text);
+            if (iter != results.end())
+                result = iter->second.get();
+        }
+        if (!result)
+            return type_safe::nullopt;
+
+        // results are never changed once stored, so it can be copied without the lock
+        ++reused_;
+        return clone(*result);
+    }
+
+    void insert(std::string_view text, bool has_matching_entity,
+                const comment::parse_result& result)
+    {
+        auto& shard = get_shard(text);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto inserted = shard.results[has_matching_entity].emplace(text, nullptr);
+            // Most comments are unique, so the first time a text is seen only a placeholder is
+            // stored. The result is only copied once the text is parsed a second time.
+            if (inserted.second || inserted.first->second)
+                return;
+        }
+
+        std::unique_ptr<comment::parse_result> copy(new comment::parse_result(clone(result)));
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto& stored = shard.results[has_matching_entity][text];
+        if (!stored)
+            // another thread might have been faster
+            stored = std::move(copy);
+    }
+
+    // removes all results but keeps the statistics
+    void clear()
+    {
+        for (auto& shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto& results : shard.results)
+                results.clear();
+        }
+    }
+
+    cache_statistics statistics() const noexcept
+    {
+        return {comments_.load(), reused_.load()};
+    }
+
+private:
+    using result_map
+        = std::unordered_map<std::string_view, std::unique_ptr<const comment::parse_result>>;
+
+    // the results are spread over multiple maps, so different threads rarely wait for each other
+    struct shard
+    {
+        std::mutex mutex;
+        result_map results[2];
+    };
+
+    shard& get_shard(std::string_view text)
+    {
+        return shards_[std::hash<std::string_view>{}(text) % shards_.size()];
+    }
+
+    std::array<shard, 16>    shards_;
+    std::atomic<std::size_t> comments_{0u}, reused_{0u};
+};
+
+file_comment_parser::file_comment_parser(
+    type_safe::object_ref<const cppast::diagnostic_logger> logger, comment::config config,
+    type_safe::optional_ref<const entity_blacklist> blacklist)
+: config_(std::move(config)),
+  blacklist_(blacklist),
+  logger_(logger),
+  id_(next_id()),
+  cache_(new comment_cache)
+{}
+
+file_comment_parser::~file_comment_parser() noexcept = default;
+
+file_comment_parser::cache_statistics file_comment_parser::statistics() const noexcept
+{
+    return cache_->statistics();
+}
+
+std::uint64_t file_comment_parser::next_id() noexcept
+{
+    static std::atomic<std::uint64_t> counter(0u);
+    return ++counter;
+}
+
+namespace
+{
+// the parser of the current thread and the file_comment_parser it belongs to
+// creating a parser copies the config and sets up cmark with all extensions,
+// so it is only done once per thread instead of once per comment
+struct thread_parser
+{
+    std::uint64_t                    owner = 0u;
+    std::unique_ptr<comment::parser> parser;
+};
+
+thread_local thread_parser cur_parser;
+} // namespace
+
+comment::parse_result file_comment_parser::parse_comment(std::string_view text,
+                                                         bool has_matching_entity) const
+{
+    if (auto cached = cache_->lookup(text, has_matching_entity))
+        return std::move(cached.value());
+
+    // ids are never reused, so the parser never has the config of another file_comment_parser
+    if (!cur_parser.parser || cur_parser.owner != id_)
+    {
+        cur_parser.parser.reset(new comment::parser(config_));
+        cur_parser.owner = id_;
+    }
+
+    try
+    {
+        auto result = comment::parse(*cur_parser.parser, text, has_matching_entity);
+        cache_->insert(text, has_matching_entity, result);
+        return result;
+    }
+    catch (comment::parse_error&)
+    {
+        // thrown after cmark has finished, the parser can be used again
+        throw;
+    }
+    catch (...)
+    {
+        // cmark might be in an inconsistent state
+        cur_parser.parser.reset();
+        throw;
+    }
+}
+
+file_comment_parser::tables& file_comment_parser::thread_tables() const
+{
+    // all entities of a file are registered by the thread parsing it,
+    // so lookups of parent entities during parsing only need the tables of the current thread
+    thread_local std::uint64_t owner = 0u;
+    thread_local tables*       cur   = nullptr;
+    if (owner != id_)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        thread_tables_.emplace_back(new tables);
+        cur   = thread_tables_.back().get();
+        owner = id_;
+    }
+    return *cur;
+}
+
 void file_comment_parser::parse(type_safe::object_ref<const cppast::cpp_file> file) const
 {
+    auto& t = thread_tables();
+
+    // the preceding sibling of the entities in the current container, if any
+    std::stack<const cppast::cpp_entity*> previous;
+    previous.push(nullptr);
+
     // add matched comments
     cppast::visit(*file, [&](const cppast::cpp_entity& entity, const cppast::visitor_info& info) {
-        if (info.event == cppast::visitor_info::container_entity_exit)
-            // entity already handled
-            return true;
-        else if (!cppast::is_templated(entity) && !cppast::is_friended(entity))
+        // the entity and its children will be excluded anyway, so don't bother parsing comments
+        auto excluded
+            = blacklist_ && blacklist_.value().is_always_excluded(entity, info.access);
+        auto pruned = excluded && info.event != cppast::visitor_info::container_entity_exit;
+        if (pruned && !entity.name().empty())
+            // `\entity` comments referring to it or its children are ignored silently
+            t.pruned.push_back(lookup_unique_name(t.registry, entity));
+
+        // entity already handled on container_entity_enter
+        if (!pruned && info.event != cppast::visitor_info::container_entity_exit
+            && !cppast::is_templated(entity) && !cppast::is_friended(entity))
         {
             auto register_commented = [&](type_safe::object_ref<const cppast::cpp_entity> e,
                                           comment::doc_comment                            comment) {
-                this->register_commented(e, std::move(comment));
+                this->register_commented(t, e, std::move(comment));
             };
             auto register_uncommented = [&](type_safe::object_ref<const cppast::cpp_entity> e) {
-                this->register_uncommented(e);
+                this->register_uncommented(t, e);
             };
 
             // parse comment
             type_safe::optional<comment::parse_result> comment;
             try
             {
-                comment = type_safe::copy(entity.comment()).map([&](const std::string& str) {
-                    return comment::parse(comment::parser(config_), str, true);
-                });
+                // the text is owned by the entity, so it doesn't need to be copied
+                if (auto text = entity.comment())
+                    comment = parse_comment(text.value(), true);
             }
             catch (comment::parse_error& ex)
             {
@@ -227,10 +502,45 @@ void file_comment_parser::parse(type_safe::object_ref<const cppast::cpp_file> fi
                 register_uncommented(type_safe::ref(entity));
 
             process_inlines(*logger_, comment, entity, register_commented, register_uncommented);
+
+            // the children are visited next and all need the unique name of their parent
+            if (info.event == cppast::visitor_info::container_entity_enter)
+                register_unique_name_prefix(t, entity);
+        }
+
+        // Add undocumented members to the group their preceding member is in.
+        // The siblings are visited in order and the comments of a file are all registered in
+        // the tables of the current thread, so this doesn't need another pass over the file.
+        if (config_.group_uncommented())
+        {
+            switch (info.event)
+            {
+            case cppast::visitor_info::container_entity_enter:
+                previous.push(nullptr);
+                break;
+            case cppast::visitor_info::container_entity_exit:
+                previous.pop();
+                [[fallthrough]];
+            case cppast::visitor_info::leaf_entity:
+                // excluded entities have no comment, so they can't be the source of a group
+                if (excluded)
+                    break;
+                if (auto group = group_uncommented(t, entity, previous.top()))
+                    t.implicit_groups.push_back(std::move(group.value()));
+                previous.top() = &entity;
+                break;
+            default:
+                throw std::logic_error(
+                    "not implemented: unknown event while grouping entities implicitly");
+            }
         }
 
-        return true;
+        if (pruned && info.event == cppast::visitor_info::container_entity_enter)
+            return cppast::continue_visit_no_children;
+        return cppast::continue_visit;
     });
+    assert(previous.size() == 1u
+           && "stack inconsistent; expected the stack to be in the original 'empty' state");
 
     // add free comments
     for (auto& free : file->unmatched_comments())
@@ -242,22 +552,26 @@ void file_comment_parser::parse(type_safe::object_ref<const cppast::cpp_file> fi
               message...));
         };
 
-        auto comment = comment::parse(comment::parser(config_), free.content, false);
+        auto comment = parse_comment(free.content, false);
         if (auto module = comment::get_module(comment.entity))
         {
             std::unique_lock<std::mutex> lock(mutex_);
-            if (!registry_.register_comment(module.value(), std::move(comment.comment.value())))
+            if (!tables_.registry.register_comment(module.value(),
+                                                   std::move(comment.comment.value())))
                 log("multiple comments for module '", module.value(), "'");
         }
         else if (auto name = comment::get_remote_entity(comment.entity))
         {
+            interned_string unique_name(name.value());
+            auto            partition = get_partition(unique_name);
+
             std::unique_lock<std::mutex> lock(mutex_);
-            free_comments_.push_back(std::move(comment));
+            free_comments_[partition].push_back(free_comment{unique_name, std::move(comment)});
         }
         else if (comment::is_file(comment.entity) || config_.free_file_comments())
         {
             // comment for current file
-            if (!register_commented(file, std::move(comment.comment.value())))
+            if (!register_commented(t, file, std::move(comment.comment.value())))
                 log("multiple file comments");
         }
         else
@@ -267,178 +581,289 @@ void file_comment_parser::parse(type_safe::object_ref<const cppast::cpp_file> fi
     }
 }
 
-comment_registry file_comment_parser::finish()
+comment_registry file_comment_parser::finish(type_safe::optional_ref<thread_pool> pool)
 {
-    resolve_free_comments();
-    if (config_.group_uncommented())
-        group_uncommented();
-    return std::move(registry_);
+    // no more comments are parsed
+    cache_->clear();
+
+    for (auto& t : thread_tables_)
+    {
+        tables_.registry.merge(std::move(t->registry), *logger_);
+        tables_.implicit_groups.insert(tables_.implicit_groups.end(),
+                                       std::make_move_iterator(t->implicit_groups.begin()),
+                                       std::make_move_iterator(t->implicit_groups.end()));
+    }
+
+    // The members were grouped while parsing, before the `\entity` comments were known.
+    // Those can document a member or put it into a group, so the grouping is redone after them.
+    auto has_free_comments = std::any_of(free_comments_.begin(), free_comments_.end(),
+                                         [](const std::vector<free_comment>& partition) {
+                                             return !partition.empty();
+                                         });
+    auto regroup = has_free_comments && !tables_.implicit_groups.empty();
+    if (regroup)
+        ungroup_uncommented();
+
+    for (auto& t : thread_tables_)
+        pruned_.insert(std::make_move_iterator(t->pruned.begin()),
+                       std::make_move_iterator(t->pruned.end()));
+
+    // The partitions refer to different entities, so they can be resolved at the same time.
+    std::vector<resolved_comments> resolved(no_partitions);
+    if (pool)
+    {
+        std::vector<std::future<void>> futures;
+        for (auto i = 0u; i != no_partitions; ++i)
+            if (!free_comments_[i].empty())
+                futures.push_back(pool.value().add_job(
+                    [&, i] { resolved[i] = resolve_free_comments(i); },
+                    double(free_comments_[i].size())));
+
+        // the jobs refer to the results, so wait for all of them before rethrowing
+        std::exception_ptr exception;
+        for (auto& future : futures)
+            try
+            {
+                future.get();
+            }
+            catch (...)
+            {
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+    else
+        for (auto i = 0u; i != no_partitions; ++i)
+            resolved[i] = resolve_free_comments(i);
+    thread_tables_.clear();
+
+    for (auto& partition : resolved)
+    {
+        for (auto entity : partition.renamed)
+            tables_.registry.forget_unique_name_prefix(*entity);
+        tables_.registry.merge(std::move(partition.comments.registry), *logger_);
+    }
+
+    if (regroup)
+        for (auto& group : tables_.implicit_groups)
+        {
+            auto result   = group_uncommented(tables_, *group.target, group.source);
+            group.grouped = result && result.value().grouped;
+        }
+
+    for (auto& group : tables_.implicit_groups)
+        if (group.grouped)
+        {
+            auto& target = *group.target;
+            tables_.registry.add_to_group(
+                tables_.registry.get_comment(target).value().metadata().group().value().name(),
+                type_safe::ref(target));
+        }
+
+    // the order of the tables depends on the threads the files were parsed on
+    tables_.registry.sort_groups();
+
+    return std::move(tables_.registry);
+}
+
+bool file_comment_parser::is_pruned(const std::string& unique_name) const
+{
+    // the children of an excluded entity weren't visited, so check the names of all parents
+    for (auto end = unique_name.size(); end != 0u && end != std::string::npos;
+         end = unique_name.rfind("::", end - 1u))
+        if (pruned_.count(unique_name.substr(0, end)) != 0u)
+            return true;
+    return false;
+}
+
+std::size_t file_comment_parser::get_partition(const interned_string& unique_name) noexcept
+{
+    return std::hash<interned_string>{}(unique_name) % no_partitions;
 }
 
-void file_comment_parser::resolve_free_comments()
+file_comment_parser::resolved_comments file_comment_parser::resolve_free_comments(
+    std::size_t partition) const
 {
+    resolved_comments result;
+
+    auto& free_comments = free_comments_[partition];
+    if (free_comments.empty())
+        return result;
+
+    // Only the entities in the same partition can be documented by these comments.
+    auto size = std::size_t(0);
+    for (auto& t : thread_tables_)
+        size += t->uncommented[partition].size();
+
+    std::unordered_multimap<interned_string, const cppast::cpp_entity*> uncommented;
+    uncommented.reserve(size);
+    for (auto& t : thread_tables_)
+        uncommented.insert(t->uncommented[partition].begin(), t->uncommented[partition].end());
+
     // Attach comments that are using the `\entity` command to the entity they're documenting.
-    for (auto& free : free_comments_)
+    for (auto& free : free_comments)
     {
         // Find all the entities that are not documented yet that match this entity command.
-        auto result = uncommented_.equal_range(comment::get_remote_entity(free.entity).value());
-        if (result.first != result.second)
+        auto entities = uncommented.equal_range(free.unique_name);
+        if (entities.first != entities.second)
         {
-            auto metadata = free.comment.value().metadata();
+            auto metadata = free.comment.comment.value().metadata();
+            if (metadata.unique_name())
+                // the unique names of the children change
+                for (auto cur = entities.first; cur != entities.second; ++cur)
+                    cppast::visit(*cur->second, [&](const cppast::cpp_entity& e,
+                                                    const cppast::visitor_info&) {
+                        result.renamed.push_back(&e);
+                        return true;
+                    });
 
             // Assign the entire comment block to the first entity found.
-            register_commented(type_safe::ref(*result.first->second),
-                               std::move(free.comment.value()), false);
+            register_commented(result.comments, type_safe::ref(*entities.first->second),
+                               std::move(free.comment.comment.value()), false);
 
             // And only the metadata to all the other entities found.
             // TODO: What is an example where this actually happens? This does not show up in our test cases.
-            for (auto cur = std::next(result.first); cur != result.second; ++cur)
-                register_commented(type_safe::ref(*cur->second),
+            for (auto cur = std::next(entities.first); cur != entities.second; ++cur)
+                register_commented(result.comments, type_safe::ref(*cur->second),
                                    comment::doc_comment(metadata, nullptr, {}), false);
 
-            uncommented_.erase(result.first, result.second);
+            uncommented.erase(entities.first, entities.second);
         }
-        else
+        else if (!is_pruned(free.unique_name.str()))
             logger_->log("standardese comment",
                          make_diagnostic(cppast::source_location(),
                                          "unable to find matching undocumented entity '",
-                                         comment::get_remote_entity(free.entity).value(),
-                                         "' for comment"));
+                                         free.unique_name.str(), "' for comment"));
     }
+
+    return result;
 }
 
-void file_comment_parser::group_uncommented()
+type_safe::optional<file_comment_parser::implicit_group> file_comment_parser::group_uncommented(
+    tables& t, const cppast::cpp_entity& target, const cppast::cpp_entity* source) const
 {
-    // Add undocumented members to the group their preceding member is in.
-    std::unordered_set<const cppast::cpp_file*> files;
-    for (const auto& uncommented : uncommented_) {
-        const cppast::cpp_entity* file = uncommented.second;
-        while (file->parent())
-            file = &file->parent().value();
-
-        assert(file->kind() == cppast::cpp_entity_kind::file_t && "all entities must live under a file root node");
+    if (source == nullptr)
+        return type_safe::nullopt;
 
-        files.insert(static_cast<const cppast::cpp_file*>(file));
+    switch (target.kind()) {
+        case cppast::cpp_entity_kind::enum_value_t:
+        case cppast::cpp_entity_kind::function_t:
+        case cppast::cpp_entity_kind::function_template_t:
+        case cppast::cpp_entity_kind::member_function_t:
+        case cppast::cpp_entity_kind::conversion_op_t:
+        case cppast::cpp_entity_kind::constructor_t:
+            break;
+        case cppast::cpp_entity_kind::destructor_t:
+            // Do not automatically group the destructor as it
+            // typically undocumented and the intention was probably
+            // just to exclude it from the output.
+            [[fallthrough]];
+        case cppast::cpp_entity_kind::enum_t:
+        case cppast::cpp_entity_kind::class_template_t:
+        case cppast::cpp_entity_kind::class_t:
+            // Do not group types automatically as this is usually not
+            // what users expect. Instead, uncommented (inner) types
+            // were probably meant to be hidden from the output.
+            [[fallthrough]];
+        case cppast::cpp_entity_kind::member_variable_t:
+        case cppast::cpp_entity_kind::file_t:
+        case cppast::cpp_entity_kind::macro_parameter_t:
+        case cppast::cpp_entity_kind::macro_definition_t:
+        case cppast::cpp_entity_kind::include_directive_t:
+        case cppast::cpp_entity_kind::language_linkage_t:
+        case cppast::cpp_entity_kind::namespace_t:
+        case cppast::cpp_entity_kind::namespace_alias_t:
+        case cppast::cpp_entity_kind::using_directive_t:
+        case cppast::cpp_entity_kind::using_declaration_t:
+        case cppast::cpp_entity_kind::type_alias_t:
+        case cppast::cpp_entity_kind::access_specifier_t:
+        case cppast::cpp_entity_kind::base_class_t:
+        case cppast::cpp_entity_kind::variable_t:
+        case cppast::cpp_entity_kind::bitfield_t:
+        case cppast::cpp_entity_kind::function_parameter_t:
+        case cppast::cpp_entity_kind::friend_t:
+        case cppast::cpp_entity_kind::template_type_parameter_t:
+        case cppast::cpp_entity_kind::non_type_template_parameter_t:
+        case cppast::cpp_entity_kind::template_template_parameter_t:
+        case cppast::cpp_entity_kind::alias_template_t:
+        case cppast::cpp_entity_kind::variable_template_t:
+        case cppast::cpp_entity_kind::function_template_specialization_t:
+        case cppast::cpp_entity_kind::class_template_specialization_t:
+        case cppast::cpp_entity_kind::static_assert_t:
+            // Do not implicitly group things that people usually
+            // don't want to be grouped or that we do not generate comments for anyway.
+            [[fallthrough]];
+        default:
+            return type_safe::nullopt;
     }
 
-    for (const auto* file : files) {
-        std::stack<const cppast::cpp_entity*> previous;
-
-        previous.push(nullptr);
+    auto target_comment = t.registry.get_comment(target);
 
-        const auto assign_group = [&](const cppast::cpp_entity& target, const cppast::cpp_entity* source) {
-            if (source == nullptr)
-                return;
-
-            switch (target.kind()) {
-                case cppast::cpp_entity_kind::enum_value_t:
-                case cppast::cpp_entity_kind::function_t:
-                case cppast::cpp_entity_kind::function_template_t:
-                case cppast::cpp_entity_kind::member_function_t:
-                case cppast::cpp_entity_kind::conversion_op_t:
-                case cppast::cpp_entity_kind::constructor_t:
-                    break;
-                case cppast::cpp_entity_kind::destructor_t:
-                    // Do not automatically group the destructor as it
-                    // typically undocumented and the intention was probably
-                    // just to exclude it from the output.
-                    [[fallthrough]];
-                case cppast::cpp_entity_kind::enum_t:
-                case cppast::cpp_entity_kind::class_template_t:
-                case cppast::cpp_entity_kind::class_t:
-                    // Do not group types automatically as this is usually not
-                    // what users expect. Instead, uncommented (inner) types
-                    // were probably meant to be hidden from the output.
-                    [[fallthrough]];
-                case cppast::cpp_entity_kind::member_variable_t:
-                case cppast::cpp_entity_kind::file_t:
-                case cppast::cpp_entity_kind::macro_parameter_t:
-                case cppast::cpp_entity_kind::macro_definition_t:
-                case cppast::cpp_entity_kind::include_directive_t:
-                case cppast::cpp_entity_kind::language_linkage_t:
-                case cppast::cpp_entity_kind::namespace_t:
-                case cppast::cpp_entity_kind::namespace_alias_t:
-                case cppast::cpp_entity_kind::using_directive_t:
-                case cppast::cpp_entity_kind::using_declaration_t:
-                case cppast::cpp_entity_kind::type_alias_t:
-                case cppast::cpp_entity_kind::access_specifier_t:
-                case cppast::cpp_entity_kind::base_class_t:
-                case cppast::cpp_entity_kind::variable_t:
-                case cppast::cpp_entity_kind::bitfield_t:
-                case cppast::cpp_entity_kind::function_parameter_t:
-                case cppast::cpp_entity_kind::friend_t:
-                case cppast::cpp_entity_kind::template_type_parameter_t:
-                case cppast::cpp_entity_kind::non_type_template_parameter_t:
-                case cppast::cpp_entity_kind::template_template_parameter_t:
-                case cppast::cpp_entity_kind::alias_template_t:
-                case cppast::cpp_entity_kind::variable_template_t:
-                case cppast::cpp_entity_kind::function_template_specialization_t:
-                case cppast::cpp_entity_kind::class_template_specialization_t:
-                case cppast::cpp_entity_kind::static_assert_t:
-                    // Do not implicitly group things that people usually
-                    // don't want to be grouped or that we do not generate comments for anyway.
-                    [[fallthrough]];
-                default:
-                    return;
-            }
-
-            auto target_comment = registry_.get_comment(target);
+    if (target_comment.has_value() && target_comment.value().metadata().group())
+        // Do not implicitly assign a group if this member already has one.
+        return type_safe::nullopt;
 
-            if (target_comment.has_value() && target_comment.value().metadata().group())
-                // Do not implicitly assign a group if this member already has one.
-                return;
+    if (target_comment.has_value() && (target_comment.value().brief_section().has_value() || !target_comment.value().sections().empty()))
+        // Do not implicitly assign a group if this member already has some comment.
+        return type_safe::nullopt;
 
-            if (target_comment.has_value() && (target_comment.value().brief_section().has_value() || !target_comment.value().sections().empty()))
-                // Do not implicitly assign a group if this member already has some comment.
-                return;
+    implicit_group result{&target, source, type_safe::nullopt, false};
+    if (target_comment.has_value())
+        result.previous = target_comment.value().metadata();
 
-            const auto source_comment = registry_.get_comment(*source);
+    const auto source_comment = t.registry.get_comment(*source);
 
-            if (!source_comment.has_value() || !source_comment.value().metadata().group().has_value())
-                // Source has no group so we cannot assign it to target.
-                return;
+    if (!source_comment.has_value() || !source_comment.value().metadata().group().has_value())
+        // Source has no group so we cannot assign it to target.
+        return result;
 
-            comment::metadata metadata;
-            metadata.set_group(source_comment.value().metadata().group().value());
+    comment::metadata metadata;
+    metadata.set_group(source_comment.value().metadata().group().value());
 
-            register_commented(type_safe::ref(target), comment::doc_comment(metadata, nullptr, {}), false);
-        };
+    // the list of members of the group is only updated in finish(),
+    // so the members that were grouped implicitly come after the ones grouped explicitly
+    t.registry.register_comment(type_safe::ref(target),
+                                comment::doc_comment(metadata, nullptr, {}));
+    result.grouped = true;
 
-        cppast::visit(*file, [&](const cppast::cpp_entity& entity, const cppast::visitor_info& info) {
-            switch(info.event) {
-                case cppast::visitor_info::container_entity_enter:
-                    previous.push(nullptr);
-                    break;
-                case cppast::visitor_info::container_entity_exit:
-                    previous.pop();
-                    [[fallthrough]];
-                case cppast::visitor_info::leaf_entity:
-                    assign_group(entity, previous.top());
-                    previous.pop();
-                    previous.push(&entity);
-                    break;
-                default:
-                    throw std::logic_error("not implemented: unknown event while grouping entities implicitly");
-            }
-        });
+    return result;
+}
 
-        assert(previous.size() == 1 && "stack inconsistent; expected the stack to be in the original 'empty' state");
+void file_comment_parser::ungroup_uncommented()
+{
+    for (auto& group : tables_.implicit_groups)
+    {
+        if (!group.grouped)
+            continue;
+
+        auto& target = *group.target;
+        tables_.registry.unregister_comment(target);
+        if (group.previous)
+            tables_.registry.register_comment(type_safe::ref(target),
+                                              comment::doc_comment(group.previous.value(),
+                                                                   nullptr, {}));
+        group.grouped = false;
     }
 }
 
-bool file_comment_parser::register_commented(type_safe::object_ref<const cppast::cpp_entity> entity,
+bool file_comment_parser::register_commented(tables&                                         t,
+                                             type_safe::object_ref<const cppast::cpp_entity> entity,
                                              comment::doc_comment comment, bool allow_cmd) const
 {
     auto cmd_comment = !comment.brief_section() && comment.sections().empty();
 
-    std::lock_guard<std::mutex> lock(mutex_);
     if (comment.metadata().group())
-        registry_.add_to_group(comment.metadata().group().value().name(), entity);
-    auto result = registry_.register_comment(entity, std::move(comment));
+        t.registry.add_to_group(comment.metadata().group().value().name(), entity);
+    auto result = t.registry.register_comment(entity, std::move(comment));
 
     if (cmd_comment && allow_cmd)
+    {
         // a pure "command" comment, allow later sections
-        uncommented_.emplace(lookup_unique_name(registry_, *entity), &*entity);
+        interned_string unique_name(lookup_unique_name(t.registry, *entity));
+        t.uncommented[get_partition(unique_name)].emplace_back(unique_name, &*entity);
+    }
 
     return result;
 }
@@ -556,52 +981,68 @@ std::string get_full_unique_name(const std::string& parent, const cppast::cpp_en
     return result;
 }
 
-template <class Lookup>
-std::string lookup_parent_unique_name(const Lookup& get_comment, const cppast::cpp_entity& e)
-{
-    auto parent = e.parent();
-    while (parent && (cppast::is_templated(parent.value()) || cppast::is_friended(parent.value())))
-        parent = parent.value().parent();
-    if (!parent)
-        return "";
+std::string lookup_parent_unique_name(const comment_registry&   registry,
+                                      const cppast::cpp_entity& e);
 
+// get the prefix of the unique names of the children of the (non-templated) entity
+std::string get_unique_name_prefix(const comment_registry&   registry,
+                                   const cppast::cpp_entity& parent)
+{
     // don't need unique name for parents that don't have a scope
     // except for functions or templates, those are fine
-    auto need_name = parent.value().scope_name() || detail::get_function(parent.value())
-                     || detail::get_template(parent.value());
+    auto need_name
+        = parent.scope_name() || detail::get_function(parent) || detail::get_template(parent);
     if (!need_name)
         return "";
 
+    auto comment = parent.scope_name() || detail::get_function(parent)
+                       ? registry.get_comment(parent)
+                       : type_safe::nullopt;
     auto result
-        = parent
-              .map([&](const cppast::cpp_entity& p) {
-                  return p.scope_name() || detail::get_function(p) ? get_comment(p)
-                                                                   : type_safe::nullopt;
-              })
-              .map([](const comment::doc_comment& c) { return c.metadata().unique_name(); });
+        = comment.map([](const comment::doc_comment& c) { return c.metadata().unique_name(); });
     if (result)
         return result.value();
 
     // parent doesn't have a unique name
-    return get_full_unique_name(lookup_parent_unique_name(get_comment, parent.value()),
-                                parent.value(), get_unique_name(parent.value()));
+    return get_full_unique_name(lookup_parent_unique_name(registry, parent), parent,
+                                get_unique_name(parent));
+}
+
+std::string lookup_parent_unique_name(const comment_registry&   registry,
+                                      const cppast::cpp_entity& e)
+{
+    auto parent = e.parent();
+    while (parent && (cppast::is_templated(parent.value()) || cppast::is_friended(parent.value())))
+        parent = parent.value().parent();
+    if (!parent)
+        return "";
+
+    // the prefix is usually remembered while parsing the comments
+    if (auto prefix = registry.lookup_unique_name_prefix(parent.value()))
+        return prefix.value();
+    return get_unique_name_prefix(registry, parent.value());
 }
 } // namespace
 
 void file_comment_parser::register_uncommented(
-    type_safe::object_ref<const cppast::cpp_entity> entity) const
+    tables& t, type_safe::object_ref<const cppast::cpp_entity> entity) const
 {
-    auto unique_name
-        = get_full_unique_name(get_parent_unique_name(*entity), *entity, get_unique_name(*entity));
+    auto unique_name = get_full_unique_name(get_parent_unique_name(t, *entity), *entity,
+                                            get_unique_name(*entity));
+    interned_string interned(unique_name);
+    t.uncommented[get_partition(interned)].emplace_back(interned, &*entity);
+}
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    uncommented_.emplace(std::move(unique_name), &*entity);
+std::string file_comment_parser::get_parent_unique_name(const tables&             t,
+                                                        const cppast::cpp_entity& e) const
+{
+    return lookup_parent_unique_name(t.registry, e);
 }
 
-std::string file_comment_parser::get_parent_unique_name(const cppast::cpp_entity& e) const
+void file_comment_parser::register_unique_name_prefix(tables&                   t,
+                                                      const cppast::cpp_entity& e) const
 {
-    return lookup_parent_unique_name([&](const cppast::cpp_entity& e) { return get_comment(e); },
-                                     e);
+    t.registry.register_unique_name_prefix(e, get_unique_name_prefix(t.registry, e));
 }
 
 std::string standardese::lookup_unique_name(const comment_registry&   registry,
@@ -612,9 +1053,7 @@ std::string standardese::lookup_unique_name(const comment_registry&   registry,
     {
         if (is_relative_unique_name(comment.value().metadata().unique_name().value()))
         {
-            auto parent = lookup_parent_unique_name([&](const cppast::cpp_entity&
-                                                            e) { return registry.get_comment(e); },
-                                                    e);
+            auto parent = lookup_parent_unique_name(registry, e);
             return get_full_unique_name(parent, e,
                                         comment.value().metadata().unique_name().value().substr(1));
         }
@@ -623,8 +1062,6 @@ std::string standardese::lookup_unique_name(const comment_registry&   registry,
     }
 
     // calculate unique name
-    auto parent = lookup_parent_unique_name([&](const cppast::cpp_entity&
-                                                    e) { return registry.get_comment(e); },
-                                            e);
+    auto parent = lookup_parent_unique_name(registry, e);
     return get_full_unique_name(parent, e, get_unique_name(e));
 }
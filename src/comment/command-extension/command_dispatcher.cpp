@@ -0,0 +1,56 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include "command_dispatcher.hpp"
+#include "../../util/enum_values.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace standardese::comment::command_extension
+{
+
+command_dispatcher::command_dispatcher(const class config& config)
+{
+    // The order of the candidates is the order in which the commands are tried.
+    for (const auto command : enum_values<command_type>())
+        add(command, config.get_command_prefixes(command));
+    for (const auto command : enum_values<section_type>())
+        add(command, config.get_command_prefixes(command));
+    for (const auto command : enum_values<inline_type>())
+        add(command, config.get_command_prefixes(command));
+}
+
+void command_dispatcher::add(command cmd, const std::vector<std::string>& prefixes)
+{
+    const auto index = unsigned(candidates_.size());
+    candidates_.push_back(candidate{cmd, prefixes});
+
+    const auto add_to = [&](std::vector<unsigned>& bucket) {
+        // A command with multiple prefixes starting with the same character is only added once.
+        if (bucket.empty() || bucket.back() != index)
+            bucket.push_back(index);
+    };
+
+    for (const auto& prefix : prefixes)
+        if (prefix.empty())
+        {
+            // This command might start with anything.
+            add_to(anything_);
+            for (auto& bucket : buckets_)
+                add_to(bucket);
+        }
+        else
+            add_to(buckets_[static_cast<unsigned char>(prefix.front())]);
+}
+
+bool command_dispatcher::candidate::matches(const char* begin, const char* end) const
+{
+    const auto length = std::size_t(end - begin);
+    return std::any_of(prefixes.begin(), prefixes.end(), [&](const std::string& prefix) {
+        return prefix.size() <= length && std::memcmp(prefix.data(), begin, prefix.size()) == 0;
+    });
+}
+
+}
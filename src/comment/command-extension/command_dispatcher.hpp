@@ -0,0 +1,67 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_COMMENT_COMMAND_EXTENSION_COMMAND_DISPATCHER_HPP_INCLUDED
+#define STANDARDESE_COMMENT_COMMAND_EXTENSION_COMMAND_DISPATCHER_HPP_INCLUDED
+
+#include <array>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <standardese/comment/commands.hpp>
+#include <standardese/comment/config.hpp>
+
+namespace standardese::comment::command_extension
+{
+    /// Selects the commands whose pattern might match at a position in a comment.
+    ///
+    /// The commands are bucketed by the first character of the literal
+    /// prefixes of their patterns, see [standardese::comment::config::get_command_prefixes](),
+    /// so text that cannot start a command is rejected with a single lookup
+    /// and only the regular expressions of the remaining commands need to be tried.
+    class command_dispatcher
+    {
+      public:
+        using command = std::variant<command_type, section_type, inline_type>;
+
+        /// Create the dispatcher for the commands of this `config`.
+        explicit command_dispatcher(const config&);
+
+        /// Invoke `f` for every command that might match at the start of
+        /// `[begin, end)`, in the order they need to be tried, until `f`
+        /// returns true.
+        template <typename Fnc>
+        void dispatch(const char* begin, const char* end, Fnc f) const
+        {
+            const auto& bucket = begin == end ? anything_ : buckets_[static_cast<unsigned char>(*begin)];
+            for (const auto index : bucket)
+            {
+                const auto& candidate = candidates_[index];
+                if (candidate.matches(begin, end) && f(candidate.cmd))
+                    return;
+            }
+        }
+
+      private:
+        struct candidate
+        {
+            command cmd;
+            std::vector<std::string> prefixes;
+
+            /// Return whether `[begin, end)` starts with one of the prefixes.
+            bool matches(const char* begin, const char* end) const;
+        };
+
+        void add(command cmd, const std::vector<std::string>& prefixes);
+
+        std::vector<candidate> candidates_;
+        /// The indices of the candidates for every first character.
+        std::array<std::vector<unsigned>, 256> buckets_;
+        /// The indices of the candidates that can match anything.
+        std::vector<unsigned> anything_;
+    };
+}
+
+#endif // STANDARDESE_COMMENT_COMMAND_EXTENSION_COMMAND_DISPATCHER_HPP_INCLUDED
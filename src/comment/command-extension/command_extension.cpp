@@ -9,6 +9,7 @@
 #include <type_traits>
 #include <cassert>
 #include <cstring>
+#include <variant>
 
 #include <cmark-gfm.h>
 #include <cmark-gfm-extension_api.h>
@@ -16,7 +17,7 @@
 namespace standardese::comment::command_extension
 {
 
-command_extension::command_extension(const class config& config, cmark_syntax_extension* extension) : config_(config), extension_(extension)
+command_extension::command_extension(const class config& config, cmark_syntax_extension* extension) : config_(config), dispatcher_(config), extension_(extension)
 {
     cmark_syntax_extension_set_get_type_string_func(extension, command_extension::cmark_get_type_string);
     cmark_syntax_extension_set_can_contain_func(extension, command_extension::cmark_can_contain);
@@ -532,26 +533,26 @@ cmark_node* command_extension::parse_command(cmark_parser* parser, cmark_node* p
 
         cmark_node_set_syntax_extension(node, extension_);
         cmark_node_set_string_content(node, nullptr);
-        user_data<type>::set(node, command, std::vector<std::string>(++std::begin(match), std::end(match)));
+        // The arguments are views into the line that cmark is currently
+        // processing, so they are copied into the node once.
+        std::vector<std::string_view> arguments;
+        arguments.reserve(match.size() - 1);
+        for (auto group = ++std::begin(match); group != std::end(match); ++group)
+            arguments.emplace_back(group->first, group->matched ? group->length() : 0);
+        user_data<type>::set(node, command, arguments);
 
         return node;
     };
 
-    // We inefficiently, try to match every command regex here. This could be
-    // done much more efficiently, e.g., by discarding any leading characters
-    // that fail to produce a partial match. But presumably, constructing the
-    // C++ AST in the first place is the relevant bottleneck anyway.
-    for (const auto command : enum_values<command_type>())
-        if (cmark_node* node = parse_command(command))
-            return node;
-    for (const auto command : enum_values<section_type>())
-        if (cmark_node* node = parse_command(command))
-            return node;
-    for (const auto command : enum_values<inline_type>())
-        if (cmark_node* node = parse_command(command))
-            return node;
+    // Only the commands whose pattern starts like the text are tried, so most
+    // lines are rejected without running any regular expression.
+    cmark_node* node = nullptr;
+    dispatcher_.dispatch(reinterpret_cast<const char*>(begin), reinterpret_cast<const char*>(end), [&](const command_dispatcher::command& command) {
+        node = std::visit(parse_command, command);
+        return node != nullptr;
+    });
 
-    return nullptr;
+    return node;
 }
 
 // Explicitly instantiate templates for the linker.
@@ -14,6 +14,7 @@
 #include <standardese/comment/config.hpp>
 
 #include "../cmark-extension/cmark_extension.hpp"
+#include "command_dispatcher.hpp"
 
 namespace standardese::comment::command_extension
 {
@@ -134,6 +135,9 @@ namespace standardese::comment::command_extension
 
         const comment::config& config_;
 
+        /// Selects the commands to try in [*parse_command]().
+        command_dispatcher dispatcher_;
+
         /// The underlying cmark extension that provides the C interface to this class.
         cmark_syntax_extension* extension_;
 
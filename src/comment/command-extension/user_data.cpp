@@ -13,7 +13,7 @@ namespace standardese::comment::command_extension
 {
 
 template <typename T>
-void user_data<T>::set(cmark_node* node, T command, std::vector<std::string> arguments)
+void user_data<T>::set(cmark_node* node, T command, const std::vector<std::string_view>& arguments)
 {
     using cmark = cmark_extension::cmark_extension;
 
@@ -22,7 +22,17 @@ void user_data<T>::set(cmark_node* node, T command, std::vector<std::string> arg
 
     auto* data = new user_data();
     data->command = command;
-    data->arguments_ = std::move(arguments);
+
+    size_t size = 0;
+    for (const auto& argument : arguments)
+        size += argument.size();
+
+    data->text_.reserve(size);
+    data->arguments_.reserve(arguments.size());
+    for (const auto& argument : arguments) {
+        data->arguments_.emplace_back(data->text_.size(), argument.size());
+        data->text_ += argument;
+    }
 
     cmark::cmark_node_set_user_data(node, data);
     cmark::cmark_node_set_user_data_free_func(node, [](cmark_mem*, void* data) {
@@ -42,13 +52,14 @@ const user_data<T>& user_data<T>::get(cmark_node* node)
 }
 
 template <typename T>
-std::string user_data<T>::argument(size_t i, size_t count) const {
-    std::string value;
+std::string_view user_data<T>::argument(size_t i, size_t count) const {
+    std::string_view value;
     for (size_t k = i; k < arguments_.size(); k += count)
     {
-        if (arguments_[k] != "") {
-            assert(value == "" && "multiple values for the same argument found; this likely means that a command's regular expression is malformed");
-            value = arguments_[k];
+        const auto [offset, length] = arguments_[k];
+        if (length != 0) {
+            assert(value.empty() && "multiple values for the same argument found; this likely means that a command's regular expression is malformed");
+            value = std::string_view(text_).substr(offset, length);
         }
     }
     return value;
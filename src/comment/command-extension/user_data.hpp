@@ -5,6 +5,8 @@
 #include <tuple>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <utility>
 
 #include <cmark-gfm.h>
 
@@ -16,7 +18,8 @@ namespace standardese::comment::command_extension
     {
       public:
         /// Associate `command` and `arguments` with this `node`.
-        static void set(cmark_node* node, T command, std::vector<std::string> arguments);
+        /// The arguments are copied into a single buffer owned by the node.
+        static void set(cmark_node* node, T command, const std::vector<std::string_view>& arguments);
 
         /// Retrieve the command and its arguments from this `node`.
         static const user_data& get(cmark_node* node);
@@ -38,9 +41,13 @@ namespace standardese::comment::command_extension
         }
 
         /// Return the value of the argument `i` (assuming that there are
-        /// `count` arguments in total.)
-        std::string argument(size_t i, size_t count) const;
+        /// `count` arguments in total.) The view is valid as long as the node.
+        std::string_view argument(size_t i, size_t count) const;
 
-        std::vector<std::string> arguments_;
+        /// The text of all arguments, one after the other.
+        std::string text_;
+
+        /// The offset and length of each argument in `text_`.
+        std::vector<std::pair<size_t, size_t>> arguments_;
     };
 }
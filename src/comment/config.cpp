@@ -6,6 +6,8 @@
 #include <standardese/comment/config.hpp>
 #include <stdexcept>
 #include <cassert>
+#include <cctype>
+#include <cstring>
 
 #include "../util/enum_values.hpp"
 
@@ -31,6 +33,71 @@ const std::string boundary = "(?:[[:space:]]+|" + eol + ")";
 const std::string word = "[[:space:]]*([^[:space:]]+)" + boundary;
 const std::string until_eol = "[[:space:]]*([^\n]*?)" + eol;
 
+// Return whether the regular expression `pattern` has an alternative at the
+// top level, i.e., outside of any group.
+bool has_toplevel_alternative(const std::string& pattern) {
+  auto depth = 0;
+  for (auto i = 0u; i < pattern.size(); ++i) {
+    const auto c = pattern[i];
+    if (c == '\\') {
+      ++i;
+    } else if (c == '[') {
+      // Skip the bracket expression, a leading ] is part of it.
+      i += pattern[i + 1] == '^' ? 2 : 1;
+      if (i < pattern.size() && pattern[i] == ']')
+        ++i;
+      while (i < pattern.size() && pattern[i] != ']') {
+        if (pattern[i] == '[' && i + 1 < pattern.size() && std::strchr(":.=", pattern[i + 1])) {
+          // Skip a character class such as [:space:].
+          const auto end = pattern.find(std::string{pattern[i + 1], ']'}, i + 2);
+          i = end == std::string::npos ? pattern.size() : end + 2;
+        } else {
+          i += pattern[i] == '\\' ? 2 : 1;
+        }
+      }
+    } else if (c == '(') {
+      ++depth;
+    } else if (c == ')') {
+      --depth;
+    } else if (c == '|' && depth == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Return the literal text that every match of the regular expression
+// `pattern` starts with. This is conservative, i.e., it stops at the first
+// thing that is not a plain character.
+std::string literal_prefix(const std::string& pattern) {
+  if (has_toplevel_alternative(pattern))
+    return "";
+
+  std::string prefix;
+  for (auto i = 0u; i < pattern.size(); ++i) {
+    char literal = pattern[i];
+    if (literal == '\\') {
+      // Escaped letters and digits are character classes, back references or
+      // anchors, everything else is the escaped character itself.
+      if (i + 1 == pattern.size() || std::isalnum(static_cast<unsigned char>(pattern[i + 1])))
+        break;
+      literal = pattern[++i];
+    } else if (std::strchr("^$.*+?()[]{}|", literal)) {
+      break;
+    }
+
+    // The character might be optional.
+    const auto next = i + 1 < pattern.size() ? pattern[i + 1] : '\0';
+    if (next == '*' || next == '?' || next == '{')
+      break;
+
+    prefix += literal;
+    if (next == '+')
+      break;
+  }
+  return prefix;
+}
+
 }
 
 std::string config::default_command_pattern(char command_character, command_type cmd)
@@ -79,7 +146,7 @@ std::string config::default_command_pattern(char command_character, inline_type
 
 config::config(const options& options) : free_file_comments_(options.free_file_comments), group_uncommented_(options.group_uncommented)
 {
-    const auto pattern = [&](const auto command) {
+    const auto patterns = [&](const auto command) {
         const std::string name = command_name(command);
         const auto fallback = default_command_pattern(options.command_character, command);
 
@@ -89,18 +156,34 @@ config::config(const options& options) : free_file_comments_(options.free_file_c
             if (specification.rfind(name, 0) != std::string::npos)
                 parameters.emplace_back(specification);
 
-        return command_pattern(parameters);
+        return command_patterns(parameters);
     };
 
-    for (const auto command : enum_values<command_type>())
-        special_command_patterns_.emplace_back(pattern(command));
-    for (const auto command : enum_values<section_type>())
-        section_command_patterns_.emplace_back(pattern(command));
-    for (const auto command : enum_values<inline_type>())
-        inline_command_patterns_.emplace_back(pattern(command));
+    const auto prefixes = [](const std::vector<std::string>& patterns) {
+        std::vector<std::string> prefixes;
+        for (const auto& pattern : patterns)
+            prefixes.emplace_back(literal_prefix(pattern));
+        return prefixes;
+    };
+
+    for (const auto command : enum_values<command_type>()) {
+        const auto p = patterns(command);
+        special_command_patterns_.emplace_back(command_pattern(p));
+        special_command_prefixes_.emplace_back(prefixes(p));
+    }
+    for (const auto command : enum_values<section_type>()) {
+        const auto p = patterns(command);
+        section_command_patterns_.emplace_back(command_pattern(p));
+        section_command_prefixes_.emplace_back(prefixes(p));
+    }
+    for (const auto command : enum_values<inline_type>()) {
+        const auto p = patterns(command);
+        inline_command_patterns_.emplace_back(command_pattern(p));
+        inline_command_prefixes_.emplace_back(prefixes(p));
+    }
 }
 
-std::regex config::command_pattern(const std::vector<std::string>& options)
+std::vector<std::string> config::command_patterns(const std::vector<std::string>& options)
 {
     if (options.size() == 0)
         throw std::invalid_argument("expected at least one pattern to merge");
@@ -124,6 +207,11 @@ std::regex config::command_pattern(const std::vector<std::string>& options)
 
     assert(patterns.size() != 0);
 
+    return patterns;
+}
+
+std::regex config::command_pattern(const std::vector<std::string>& patterns)
+{
     if (patterns.size() == 1)
         return std::regex(*begin(patterns));
 
@@ -231,6 +319,21 @@ const std::regex& config::get_command_pattern(inline_type type) const
     return inline_command_patterns_[unsigned(type)];
 }
 
+const std::vector<std::string>& config::get_command_prefixes(command_type cmd) const
+{
+    return special_command_prefixes_[unsigned(cmd)];
+}
+
+const std::vector<std::string>& config::get_command_prefixes(section_type section) const
+{
+    return section_command_prefixes_[unsigned(section)];
+}
+
+const std::vector<std::string>& config::get_command_prefixes(inline_type type) const
+{
+    return inline_command_prefixes_[unsigned(type)];
+}
+
 const char* config::inline_section_name(section_type section) const
 {
     switch (section)
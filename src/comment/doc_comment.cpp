@@ -30,6 +30,19 @@ doc_comment standardese::comment::merge(metadata data, doc_comment&& other)
     return doc_comment(std::move(data), std::move(other.brief_), std::move(other.sections_));
 }
 
+doc_comment standardese::comment::clone(const doc_comment& comment)
+{
+    std::vector<std::unique_ptr<markup::doc_section>> sections;
+    sections.reserve(comment.sections().size());
+    for (auto& sec : comment.sections())
+        sections.push_back(markup::clone(sec));
+
+    return doc_comment(comment.metadata(),
+                       comment.brief_section() ? markup::clone(comment.brief_section().value())
+                                               : nullptr,
+                       std::move(sections));
+}
+
 namespace
 {
 template <class Builder>
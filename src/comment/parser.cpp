@@ -85,9 +85,9 @@ private:
     cmark_node* root_;
 };
 
-ast_root read_ast(const parser& p, const std::string& comment)
+ast_root read_ast(const parser& p, std::string_view comment)
 {
-    cmark_parser_feed(p.get(), comment.c_str(), comment.size());
+    cmark_parser_feed(p.get(), comment.data(), comment.size());
     auto root = cmark_parser_finish(p.get());
     return ast_root(root);
 }
@@ -428,16 +428,16 @@ member_group parse_group(cmark_node* node)
 
     type_safe::optional<std::string> heading;
     if (heading_.size() != 0)
-        heading = heading_;
+        heading = std::string(heading_);
 
     if (name.front() == '-')
     {
         // name starts with -, erase it, and don't consider it a section
-        name.erase(name.begin());
-        return member_group(std::move(name), std::move(heading), false);
+        name.remove_prefix(1u);
+        return member_group(std::string(name), std::move(heading), false);
     }
     else
-        return member_group(std::move(name), std::move(heading), true);
+        return member_group(std::string(name), std::move(heading), true);
 }
 
 // builder is nullptr when parsing an inline comment
@@ -455,21 +455,21 @@ void parse_command_impl(comment_builder* builder, bool has_matching_entity, meta
     case command_type::unique_name:
         {
             auto [name] = data_.arguments<1>();
-            if (!data.set_unique_name(name))
+            if (!data.set_unique_name(std::string(name)))
               error(node, "multiple unique name commands for entity");
         }
         break;
     case command_type::output_name:
         {
             auto [name] = data_.arguments<1>();
-            if (!data.set_output_name(name))
+            if (!data.set_output_name(std::string(name)))
               error(node, "multiple output name commands for entity");
         }
         break;
     case command_type::synopsis:
         {
             auto [synopsis] = data_.arguments<1>();
-            if (!data.set_synopsis(synopsis))
+            if (!data.set_synopsis(std::string(synopsis)))
                 error(node, "multiple synopsis commands for entity");
         }
         break;
@@ -486,9 +486,9 @@ void parse_command_impl(comment_builder* builder, bool has_matching_entity, meta
 
         if (!has_matching_entity && builder && !builder->entity.has_value())
             // non-inline comment and not remote, treat as module comment
-            builder->entity = comment::module(module);
+            builder->entity = comment::module(std::string(module));
         // otherwise treat as module specification
-        else if (!data.set_module(module))
+        else if (!data.set_module(std::string(module)))
             error(node, "multiple module commands for entity");
         break;
     }
@@ -497,7 +497,7 @@ void parse_command_impl(comment_builder* builder, bool has_matching_entity, meta
         const auto [heading] = data_.arguments<1>();
         if (data.group())
             error(node, "cannot have group and output section");
-        else if (!data.set_output_section(heading))
+        else if (!data.set_output_section(std::string(heading)))
             error(node, "multiple output section commands for entity");
         break;
     }
@@ -510,7 +510,7 @@ void parse_command_impl(comment_builder* builder, bool has_matching_entity, meta
         else if (builder->entity.has_value())
             error(node, "multiple file/entity/module commands for entity");
         else
-            builder->entity = remote_entity(id);
+            builder->entity = remote_entity(std::string(id));
         break;
     }
     case command_type::file:
@@ -554,9 +554,9 @@ matching_entity parse_matching(cmark_node* node)
     {
     case inline_type::param:
     case inline_type::tparam:
-        return inline_param(entity);
+        return inline_param(std::string(entity));
     case inline_type::base:
-        return inline_base(entity);
+        return inline_base(std::string(entity));
     default:
         throw std::logic_error("not implemented: unsupported inline type");
     }
@@ -719,7 +719,7 @@ void add_children(const config& c, Builder& b, bool has_matching_entity, cmark_n
 }
 } // namespace
 
-parse_result comment::parse(const parser& p, const std::string& comment, bool has_matching_entity)
+parse_result comment::parse(const parser& p, std::string_view comment, bool has_matching_entity)
 {
     auto root = read_ast(p, comment);
 
@@ -229,6 +229,7 @@ public:
 
     std::unique_ptr<markup::code_block> finish()
     {
+        flush_tokens();
         return builder_.finish();
     }
 
@@ -355,19 +356,19 @@ private:
     void do_write_token_seq(cppast::string_view tokens) override
     {
         update_indent();
-        builder_.add_child(markup::text::build(tokens.c_str()));
+        tokens_.add_text(tokens.c_str());
     }
 
     void do_write_keyword(cppast::string_view keyword) override
     {
         update_indent();
-        builder_.add_child(markup::code_block::keyword::build(keyword.c_str()));
+        tokens_.add_token(markup::entity_kind::code_block_keyword, keyword.c_str());
     }
 
     void write_identifier(cppast::string_view identifier)
     {
         if (identifier.length() > 0u)
-            builder_.add_child(markup::code_block::identifier::build(identifier.c_str()));
+            tokens_.add_token(markup::entity_kind::code_block_identifier, identifier.c_str());
     }
 
     bool write_link(const doc_entity& entity, cppast::string_view name)
@@ -377,6 +378,7 @@ private:
             // only generate link if the entity has actual documentation
             markup::documentation_link::builder link(entity.link_name());
             link.add_child(markup::code_block::identifier::build(name.c_str()));
+            flush_tokens();
             builder_.add_child(link.finish());
         }
         else if (entity.is_excluded())
@@ -429,37 +431,37 @@ private:
     void do_write_punctuation(cppast::string_view punct) override
     {
         update_indent();
-        builder_.add_child(markup::code_block::punctuation::build(punct.c_str()));
+        tokens_.add_token(markup::entity_kind::code_block_punctuation, punct.c_str());
     }
 
     void do_write_str_literal(cppast::string_view str) override
     {
         update_indent();
-        builder_.add_child(markup::code_block::string_literal::build(str.c_str()));
+        tokens_.add_token(markup::entity_kind::code_block_string_literal, str.c_str());
     }
 
     void do_write_int_literal(cppast::string_view str) override
     {
         update_indent();
-        builder_.add_child(markup::code_block::int_literal::build(str.c_str()));
+        tokens_.add_token(markup::entity_kind::code_block_int_literal, str.c_str());
     }
 
     void do_write_float_literal(cppast::string_view str) override
     {
         update_indent();
-        builder_.add_child(markup::code_block::float_literal::build(str.c_str()));
+        tokens_.add_token(markup::entity_kind::code_block_float_literal, str.c_str());
     }
 
     void do_write_preprocessor(cppast::string_view punct) override
     {
         update_indent();
-        builder_.add_child(markup::code_block::preprocessor::build(punct.c_str()));
+        tokens_.add_token(markup::entity_kind::code_block_preprocessor, punct.c_str());
     }
 
     void write_excluded()
     {
         update_indent();
-        builder_.add_child(markup::code_block::identifier::build(config_->hidden_name()));
+        tokens_.add_token(markup::entity_kind::code_block_identifier, config_->hidden_name());
     }
 
     void do_write_excluded(const cppast::cpp_entity&) override
@@ -469,26 +471,35 @@ private:
 
     void do_write_newline() override
     {
-        builder_.add_child(markup::soft_break::build());
+        tokens_.add_soft_break();
         need_indent_.set();
     }
 
     void do_write_whitespace() override
     {
         update_indent();
-        builder_.add_child(markup::text::build(" "));
+        tokens_.add_text(" ");
     }
 
     void update_indent()
     {
         if (need_indent_.try_reset())
-            builder_.add_child(markup::text::build(std::string(level_, ' ')));
+            tokens_.add_text(std::string(level_, ' '));
+    }
+
+    // adjacent tokens are collected in a single sequence,
+    // only links need to be separate entities
+    void flush_tokens()
+    {
+        if (!tokens_.empty())
+            builder_.add_child(tokens_.finish());
     }
 
     type_safe::object_ref<const synopsis_config>          config_;
     type_safe::object_ref<const cppast::cpp_entity_index> index_;
 
-    markup::code_block::builder builder_;
+    markup::code_block::builder                 builder_;
+    markup::code_block::token_sequence::builder tokens_;
 
     std::stack<type_safe::object_ref<const cppast::cpp_entity>> entities_;
 
@@ -1123,15 +1134,12 @@ bool is_class(const cppast::cpp_entity& e)
            || e.kind() == cppast::cpp_entity_kind::class_template_specialization_t;
 }
 
-bool is_excluded(const cppast::cpp_entity& e, cppast::cpp_access_specifier_kind access,
-                 type_safe::optional_ref<const comment::doc_comment> comment,
-                 const cppast::cpp_entity_index& index, const entity_blacklist& blacklist, bool hide_uncommented)
+} // namespace
+
+bool entity_blacklist::is_always_excluded(const cppast::cpp_entity&         e,
+                                          cppast::cpp_access_specifier_kind access) const
 {
-    if (blacklist.is_blacklisted(e, access))
-        return true;
-    else if (!comment && (is_class(e) || e.kind() == cppast::cpp_entity_kind::enum_t)
-             && !cppast::is_definition(e))
-        // remove uncommented type forward declarations
+    if (is_blacklisted(e, access))
         return true;
     else if (e.parent() && !is_class(e.parent().value())
              && e.kind() == cppast::cpp_static_assert::kind())
@@ -1141,6 +1149,22 @@ bool is_excluded(const cppast::cpp_entity& e, cppast::cpp_access_specifier_kind
              && is_include_guard_macro(static_cast<const cppast::cpp_macro_definition&>(e)))
         // exclude include guards
         return true;
+    else
+        return false;
+}
+
+namespace
+{
+bool is_excluded(const cppast::cpp_entity& e, cppast::cpp_access_specifier_kind access,
+                 type_safe::optional_ref<const comment::doc_comment> comment,
+                 const cppast::cpp_entity_index& index, const entity_blacklist& blacklist, bool hide_uncommented)
+{
+    if (blacklist.is_always_excluded(e, access))
+        return true;
+    else if (!comment && (is_class(e) || e.kind() == cppast::cpp_entity_kind::enum_t)
+             && !cppast::is_definition(e))
+        // remove uncommented type forward declarations
+        return true;
     else if (e.kind() == cppast::cpp_include_directive::kind()
              && !is_include_file_parsed(index,
                                         static_cast<const cppast::cpp_include_directive&>(e)))
@@ -60,9 +60,17 @@ std::unique_ptr<markup::entity_index_item> get_entity_entry(
 
     if (brief)
     {
+        // links are resolved per document, so they can't be shared,
+        // but everything else is immutable and lives as long as the comment
+        auto has_links = !markup::visit(brief.value(), {markup::entity_kind::documentation_link},
+                                        [](const markup::entity&) { return false; });
+
         markup::description::builder description;
-        for (auto& child : brief.value())
-            description.add_child(markup::clone(child));
+        if (has_links)
+            for (auto& child : brief.value())
+                description.add_child(markup::clone(child));
+        else
+            description.add_child(markup::borrowed_phrasing::build(brief.value()));
 
         return markup::entity_index_item::build(markup::block_id(std::move(link_name)),
                                                 std::move(term), description.finish());
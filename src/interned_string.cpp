@@ -0,0 +1,89 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/interned_string.hpp>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+using namespace standardese;
+
+namespace
+{
+class string_table
+{
+public:
+    const detail::interned_entry* intern(std::string_view str)
+    {
+        auto&                       shard = get_shard(str);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto iter = shard.entries.find(str);
+        if (iter != shard.entries.end())
+            return iter->second.get();
+
+        std::unique_ptr<detail::interned_entry> entry(
+            new detail::interned_entry{std::string(str), next_id_++});
+        // the key refers to the string of the entry, which doesn't move
+        std::string_view key(entry->str);
+        return shard.entries.emplace(key, std::move(entry)).first->second.get();
+    }
+
+    const detail::interned_entry* lookup(std::string_view str)
+    {
+        auto&                       shard = get_shard(str);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto iter = shard.entries.find(str);
+        return iter == shard.entries.end() ? nullptr : iter->second.get();
+    }
+
+private:
+    // the strings are spread over multiple maps, so different threads rarely wait for each other
+    struct shard
+    {
+        std::mutex                                                                  mutex;
+        std::unordered_map<std::string_view, std::unique_ptr<detail::interned_entry>> entries;
+    };
+
+    shard& get_shard(std::string_view str)
+    {
+        return shards_[std::hash<std::string_view>{}(str) % shards_.size()];
+    }
+
+    std::array<shard, 32>      shards_;
+    std::atomic<std::uint32_t> next_id_{1u};
+};
+
+string_table& get_table()
+{
+    // never destroyed, so interned strings in static objects stay valid
+    static auto table = new string_table;
+    return *table;
+}
+} // namespace
+
+interned_string::interned_string(std::string_view str)
+: entry_(str.empty() ? nullptr : get_table().intern(str))
+{}
+
+type_safe::optional<interned_string> interned_string::lookup(std::string_view str)
+{
+    if (str.empty())
+        return interned_string();
+
+    auto entry = get_table().lookup(str);
+    if (!entry)
+        return type_safe::nullopt;
+    return interned_string(entry);
+}
+
+const std::string& interned_string::str() const noexcept
+{
+    static const std::string empty;
+    return entry_ ? entry_->str : empty;
+}
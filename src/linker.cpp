@@ -102,13 +102,13 @@ bool linker::register_documentation(std::string link_name, const markup::documen
 {
     auto ref = markup::block_reference(document.output_name(), documentation);
 
-    link_name       = process_link_name(std::move(link_name));
-    auto short_name = short_link_name(link_name);
+    auto long_name  = interned_string(process_link_name(std::move(link_name)));
+    auto short_name = interned_string(short_link_name(long_name.str()));
 
     std::lock_guard<std::mutex> lock(mutex_);
 
     // insert long name
-    auto result = map_.emplace(std::move(link_name), ref);
+    auto result = map_.emplace(long_name, ref);
     if (!result.second) // not inserted
     {
         if (force)
@@ -120,7 +120,7 @@ bool linker::register_documentation(std::string link_name, const markup::documen
     // insert short name
     if (short_name != result.first->first)
     {
-        result = map_.emplace(std::move(short_name), ref);
+        result = map_.emplace(short_name, ref);
         if (!result.second)
         {
             if (force)
@@ -187,8 +187,13 @@ type_safe::variant<type_safe::nullvar_t, markup::block_reference, markup::url> l
     // performs local lookup
     auto do_lookup = [&](const std::string& link_name)
         -> type_safe::variant<type_safe::nullvar_t, markup::block_reference, markup::url> {
+        // a name that was never interned can't have been registered
+        auto name = interned_string::lookup(process_link_name(link_name));
+        if (!name)
+            return type_safe::nullvar;
+
         std::lock_guard<std::mutex> lock(mutex_);
-        auto                        iter = map_.find(process_link_name(link_name));
+        auto                        iter = map_.find(name.value());
         if (iter == map_.end())
             return type_safe::nullvar;
         return iter->second;
@@ -227,14 +232,17 @@ template <class FileVisitor, class DocVisitor>
 void visit_documentations(const markup::document_entity& document, const FileVisitor& file_visitor,
                           const DocVisitor& doc_visitor)
 {
-    markup::visit(document, [&](const markup::entity& e) {
-        if (e.kind() == markup::entity_kind::file_documentation)
-            file_visitor(static_cast<const markup::file_documentation&>(e));
-        else if (e.kind() == markup::entity_kind::namespace_documentation
-                 || e.kind() == markup::entity_kind::module_documentation)
-            // note: no need to handle entity_documentation
-            doc_visitor(static_cast<const markup::documentation_entity&>(e));
-    });
+    // note: no need to handle entity_documentation
+    markup::visit(document,
+                  {markup::entity_kind::file_documentation,
+                   markup::entity_kind::namespace_documentation,
+                   markup::entity_kind::module_documentation},
+                  [&](const markup::entity& e) {
+                      if (e.kind() == markup::entity_kind::file_documentation)
+                          file_visitor(static_cast<const markup::file_documentation&>(e));
+                      else
+                          doc_visitor(static_cast<const markup::documentation_entity&>(e));
+                  });
 }
 
 bool is_injected(const doc_entity& doc_e)
@@ -386,8 +394,14 @@ void standardese::resolve_links(const cppast::diagnostic_logger& logger, const l
         return markup::block_id();
     };
 
+    // only the links and the entities that change the context need to be visited
+    markup::entity_kind_set kinds{markup::entity_kind::documentation_link,
+                                  markup::entity_kind::file_documentation,
+                                  markup::entity_kind::entity_documentation,
+                                  markup::entity_kind::namespace_documentation};
+
     type_safe::optional_ref<const cppast::cpp_entity> context;
-    markup::visit(document, [&](const markup::entity& entity) {
+    markup::visit(document, kinds, [&](const markup::entity& entity) {
         if (entity.kind() == markup::entity_kind::documentation_link)
         {
             auto& link = static_cast<const markup::documentation_link&>(entity);
@@ -0,0 +1,135 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/markup/arena.hpp>
+
+#include <atomic>
+#include <new>
+
+using namespace standardese::markup;
+
+namespace
+{
+// every allocation is prefixed with the arena it belongs to, or null if it is on the heap
+constexpr auto header_size = alignof(std::max_align_t);
+
+static_assert(sizeof(detail::node_arena*) <= header_size, "header too small");
+
+constexpr std::size_t round_up(std::size_t size) noexcept
+{
+    return (size + header_size - 1u) / header_size * header_size;
+}
+
+thread_local detail::node_arena* current_arena = nullptr;
+} // namespace
+
+class detail::node_arena
+{
+public:
+    node_arena() noexcept : blocks_(nullptr), cur_(nullptr), end_(nullptr), references_(1u) {}
+
+    node_arena(const node_arena&) = delete;
+    node_arena& operator=(const node_arena&) = delete;
+
+    ~node_arena() noexcept
+    {
+        while (blocks_)
+        {
+            auto next = blocks_->next;
+            ::operator delete(blocks_);
+            blocks_ = next;
+        }
+    }
+
+    // only called by the thread the arena is current on
+    void* allocate(std::size_t size)
+    {
+        if (size > block_size / 4u)
+            // big allocations get a block of their own, so the current one isn't wasted
+            return add_block(size, false);
+        else if (std::size_t(end_ - cur_) < size)
+            cur_ = static_cast<char*>(add_block(block_size, true));
+
+        auto memory = cur_;
+        cur_ += size;
+        return memory;
+    }
+
+    void acquire() noexcept
+    {
+        references_.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    // entities can be destroyed on a different thread than they were created on
+    void release() noexcept
+    {
+        if (references_.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+            delete this;
+    }
+
+private:
+    static constexpr std::size_t block_size = 64u * 1024u;
+
+    struct block
+    {
+        block* next;
+    };
+
+    static constexpr auto block_header_size = round_up(sizeof(block));
+
+    void* add_block(std::size_t size, bool is_current)
+    {
+        auto memory    = static_cast<char*>(::operator new(block_header_size + size));
+        auto new_block = ::new (memory) block{blocks_};
+        blocks_        = new_block;
+
+        if (is_current)
+            end_ = memory + block_header_size + size;
+        return memory + block_header_size;
+    }
+
+    block*                   blocks_;
+    char*                    cur_;
+    char*                    end_;
+    std::atomic<std::size_t> references_;
+};
+
+void* detail::allocate_node(std::size_t size)
+{
+    size = header_size + round_up(size);
+
+    auto arena = current_arena;
+    auto memory
+        = static_cast<char*>(arena ? arena->allocate(size) : ::operator new(size));
+    ::new (memory) node_arena*(arena);
+    if (arena)
+        arena->acquire();
+
+    return memory + header_size;
+}
+
+void detail::deallocate_node(void* memory) noexcept
+{
+    if (!memory)
+        return;
+
+    auto header = static_cast<char*>(memory) - header_size;
+    if (auto arena = *reinterpret_cast<node_arena**>(header))
+        // the memory itself is released together with the arena
+        arena->release();
+    else
+        ::operator delete(header);
+}
+
+detail::arena_scope::arena_scope() : arena_(new node_arena), previous_(current_arena)
+{
+    current_arena = arena_;
+}
+
+detail::arena_scope::~arena_scope() noexcept
+{
+    current_arena = previous_;
+    // entities allocated in the arena keep it alive
+    arena_->release();
+}
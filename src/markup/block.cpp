@@ -34,8 +34,8 @@ void escape_char(std::string& str, char c)
 std::string block_id::as_output_str() const
 {
     std::string id;
-    id.reserve(id_.size());
-    for (auto c : id_)
+    id.reserve(as_str().size());
+    for (auto c : as_str())
         escape_char(id, c);
     return id;
 }
@@ -4,6 +4,8 @@
 
 #include <standardese/markup/code_block.hpp>
 
+#include <cassert>
+
 #include <standardese/markup/entity_kind.hpp>
 
 using namespace standardese::markup;
@@ -61,3 +63,58 @@ std::unique_ptr<entity> code_block::do_clone() const
         b.add_child(detail::unchecked_downcast<phrasing_entity>(child.clone()));
     return b.finish();
 }
+
+void code_block::token_sequence::append(entity_kind kind, std::string_view text)
+{
+    text_ += text;
+    tokens_.push_back(token_end{kind, static_cast<std::uint32_t>(text_.size())});
+}
+
+code_block::token_sequence::builder& code_block::token_sequence::builder::add_text(
+    std::string_view text)
+{
+    if (text.empty())
+        return *this;
+    else if (!result_->tokens_.empty() && result_->tokens_.back().kind == entity_kind::text)
+    {
+        result_->text_ += text;
+        result_->tokens_.back().end = static_cast<std::uint32_t>(result_->text_.size());
+    }
+    else
+        result_->append(entity_kind::text, text);
+    return *this;
+}
+
+code_block::token_sequence::builder& code_block::token_sequence::builder::add_soft_break()
+{
+    result_->append(entity_kind::soft_break, "\n");
+    return *this;
+}
+
+code_block::token_sequence::builder& code_block::token_sequence::builder::add_token(
+    entity_kind kind, std::string_view text)
+{
+    assert(kind == entity_kind::code_block_keyword || kind == entity_kind::code_block_identifier
+           || kind == entity_kind::code_block_string_literal
+           || kind == entity_kind::code_block_int_literal
+           || kind == entity_kind::code_block_float_literal
+           || kind == entity_kind::code_block_punctuation
+           || kind == entity_kind::code_block_preprocessor);
+    result_->append(kind, text);
+    return *this;
+}
+
+entity_kind code_block::token_sequence::do_get_kind() const noexcept
+{
+    return entity_kind::code_block_token_sequence;
+}
+
+void code_block::token_sequence::do_visit(detail::visitor_callback_t, void*) const {}
+
+std::unique_ptr<entity> code_block::token_sequence::do_clone() const
+{
+    std::unique_ptr<token_sequence> result(new token_sequence());
+    result->text_   = text_;
+    result->tokens_ = tokens_;
+    return result;
+}
@@ -15,6 +15,7 @@ bool standardese::markup::is_phrasing(standardese::markup::entity_kind kind) noe
     case entity_kind::code_block_float_literal:
     case entity_kind::code_block_punctuation:
     case entity_kind::code_block_preprocessor:
+    case entity_kind::code_block_token_sequence:
     case entity_kind::text:
     case entity_kind::emphasis:
     case entity_kind::strong_emphasis:
@@ -22,6 +23,7 @@ bool standardese::markup::is_phrasing(standardese::markup::entity_kind kind) noe
     case entity_kind::verbatim:
     case entity_kind::soft_break:
     case entity_kind::hard_break:
+    case entity_kind::borrowed_phrasing:
     case entity_kind::term:
     case entity_kind::description:
     case entity_kind::external_link:
@@ -92,6 +94,7 @@ bool standardese::markup::is_block(standardese::markup::entity_kind kind) noexce
     case entity_kind::code_block_float_literal:
     case entity_kind::code_block_punctuation:
     case entity_kind::code_block_preprocessor:
+    case entity_kind::code_block_token_sequence:
     case entity_kind::text:
     case entity_kind::emphasis:
     case entity_kind::strong_emphasis:
@@ -99,6 +102,7 @@ bool standardese::markup::is_block(standardese::markup::entity_kind kind) noexce
     case entity_kind::verbatim:
     case entity_kind::soft_break:
     case entity_kind::hard_break:
+    case entity_kind::borrowed_phrasing:
     case entity_kind::term:
     case entity_kind::description:
     case entity_kind::external_link:
@@ -147,6 +151,7 @@ bool standardese::markup::is_documentation(standardese::markup::entity_kind kind
     case entity_kind::code_block_float_literal:
     case entity_kind::code_block_punctuation:
     case entity_kind::code_block_preprocessor:
+    case entity_kind::code_block_token_sequence:
     case entity_kind::brief_section:
     case entity_kind::details_section:
     case entity_kind::inline_section:
@@ -159,6 +164,7 @@ bool standardese::markup::is_documentation(standardese::markup::entity_kind kind
     case entity_kind::verbatim:
     case entity_kind::soft_break:
     case entity_kind::hard_break:
+    case entity_kind::borrowed_phrasing:
     case entity_kind::external_link:
     case entity_kind::documentation_link:
         break;
@@ -166,3 +172,91 @@ bool standardese::markup::is_documentation(standardese::markup::entity_kind kind
 
     return false;
 }
+
+namespace
+{
+using standardese::markup::entity_kind;
+using standardese::markup::entity_kind_set;
+
+static_assert(static_cast<unsigned>(entity_kind::documentation_link) < 64u,
+              "entity_kind_set is too small");
+
+entity_kind_set get_phrasing_kinds() noexcept
+{
+    entity_kind_set result;
+    for (auto i = 0u; i <= static_cast<unsigned>(entity_kind::documentation_link); ++i)
+        if (standardese::markup::is_phrasing(static_cast<entity_kind>(i)))
+            result.insert(static_cast<entity_kind>(i));
+    return result;
+}
+} // namespace
+
+entity_kind_set standardese::markup::get_descendant_kinds(entity_kind kind) noexcept
+{
+    static const auto phrasing = get_phrasing_kinds();
+
+    switch (kind)
+    {
+    case entity_kind::code_block_keyword:
+    case entity_kind::code_block_identifier:
+    case entity_kind::code_block_string_literal:
+    case entity_kind::code_block_int_literal:
+    case entity_kind::code_block_float_literal:
+    case entity_kind::code_block_punctuation:
+    case entity_kind::code_block_preprocessor:
+    case entity_kind::code_block_token_sequence:
+    case entity_kind::thematic_break:
+    case entity_kind::text:
+    case entity_kind::verbatim:
+    case entity_kind::soft_break:
+    case entity_kind::hard_break:
+        return {};
+
+    // only phrasing children
+    case entity_kind::entity_index_item:
+    case entity_kind::heading:
+    case entity_kind::subheading:
+    case entity_kind::paragraph:
+    case entity_kind::term:
+    case entity_kind::description:
+    case entity_kind::term_description_item:
+    case entity_kind::code_block:
+    case entity_kind::brief_section:
+    case entity_kind::inline_section:
+    case entity_kind::emphasis:
+    case entity_kind::strong_emphasis:
+    case entity_kind::code:
+    case entity_kind::external_link:
+    case entity_kind::documentation_link:
+    case entity_kind::borrowed_phrasing:
+        return phrasing;
+
+    case entity_kind::file_index:
+    {
+        auto result = phrasing;
+        result.insert(entity_kind::heading);
+        result.insert(entity_kind::entity_index_item);
+        return result;
+    }
+
+    // arbitrary blocks
+    case entity_kind::main_document:
+    case entity_kind::subdocument:
+    case entity_kind::template_document:
+    case entity_kind::file_documentation:
+    case entity_kind::entity_documentation:
+    case entity_kind::namespace_documentation:
+    case entity_kind::module_documentation:
+    case entity_kind::entity_index:
+    case entity_kind::module_index:
+    case entity_kind::list_item:
+    case entity_kind::unordered_list:
+    case entity_kind::ordered_list:
+    case entity_kind::block_quote:
+    case entity_kind::details_section:
+    case entity_kind::list_section:
+        break;
+    }
+
+    return entity_kind_set::all();
+}
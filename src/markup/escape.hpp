@@ -7,7 +7,9 @@
 
 #include <cstdio>
 #include <cstring>
-#include <ostream>
+#include <string_view>
+
+#include <standardese/markup/output_buffer.hpp>
 
 namespace standardese
 {
@@ -15,30 +17,44 @@ namespace markup
 {
     namespace detail
     {
-        inline void write_html_text(std::ostream& out, const char* str)
+        inline const char* get_html_entity(char c) noexcept
         {
             // implements rule 1 here:
             // https://www.owasp.org/index.php/XSS_(Cross_Site_Scripting)_Prevention_Cheat_Sheet
-            for (auto ptr = str; *ptr; ++ptr)
+            switch (c)
             {
-                auto c = *ptr;
-                if (c == '&')
-                    out << "&amp;";
-                else if (c == '<')
-                    out << "&lt;";
-                else if (c == '>')
-                    out << "&gt;";
-                else if (c == '"')
-                    out << "&quot;";
-                else if (c == '\'')
-                    out << "&#x27;";
-                else if (c == '/')
-                    out << "&#x2F;";
-                else
-                    out << c;
+            case '&':
+                return "&amp;";
+            case '<':
+                return "&lt;";
+            case '>':
+                return "&gt;";
+            case '"':
+                return "&quot;";
+            case '\'':
+                return "&#x27;";
+            case '/':
+                return "&#x2F;";
+            default:
+                return nullptr;
             }
         }
 
+        inline void write_html_text(output_buffer& out, std::string_view str)
+        {
+            // characters that don't need escaping are appended in bulk
+            auto begin = str.data();
+            auto end   = begin + str.size();
+            for (auto cur = begin; cur != end; ++cur)
+                if (auto escaped = get_html_entity(*cur))
+                {
+                    out.append(std::string_view(begin, std::size_t(cur - begin)));
+                    out.append(escaped);
+                    begin = cur + 1;
+                }
+            out.append(std::string_view(begin, std::size_t(end - begin)));
+        }
+
         inline bool needs_url_escaping(char c)
         {
             // don't escape reserved URL characters
@@ -50,7 +66,7 @@ namespace markup
             return std::strchr(safe, c) == nullptr;
         }
 
-        inline void write_html_url(std::ostream& out, const char* url)
+        inline void write_html_url(output_buffer& out, const char* url)
         {
             for (auto ptr = url; *ptr; ++ptr)
             {
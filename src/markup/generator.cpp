@@ -4,16 +4,30 @@
 
 #include <standardese/markup/generator.hpp>
 
-#include <fstream>
-#include <sstream>
+#include <ostream>
 
 #include <standardese/markup/document.hpp>
 
 using namespace standardese::markup;
 
-std::string standardese::markup::render(generator gen, const entity& e)
+namespace
 {
-    std::ostringstream stream;
-    gen(stream, e);
-    return stream.str();
+// enough for most entities, so the buffer rarely needs to grow
+constexpr std::size_t initial_capacity = 4u * 1024u;
+} // namespace
+
+std::string standardese::markup::render(const generator& gen, const entity& e)
+{
+    output_buffer buffer(initial_capacity);
+    gen(buffer, e);
+    return buffer.release();
+}
+
+void standardese::markup::render(const generator& gen, std::ostream& out, const entity& e)
+{
+    output_buffer buffer(initial_capacity);
+    gen(buffer, e);
+
+    auto str = buffer.view();
+    out.write(str.data(), std::streamsize(str.size()));
 }
@@ -5,7 +5,7 @@
 #include <standardese/markup/generator.hpp>
 
 #include <cassert>
-#include <ostream>
+#include <string_view>
 
 #include <type_safe/deferred_construction.hpp>
 #include <type_safe/flag.hpp>
@@ -36,7 +36,7 @@ namespace
 class html_stream
 {
 public:
-    explicit html_stream(type_safe::object_ref<std::ostream> out, std::string prefix,
+    explicit html_stream(type_safe::object_ref<output_buffer> out, std::string prefix,
                          std::string extension)
     : out_(out), prefix_(std::move(prefix)), ext_(std::move(extension)), top_level_(true),
       closing_newl_(false)
@@ -129,16 +129,11 @@ public:
     }
 
     // writes HTML text, properly escaped
-    void write(const char* str)
+    void write(std::string_view str)
     {
         detail::write_html_text(*out_, str);
     }
 
-    void write(const std::string& str)
-    {
-        write(str.c_str());
-    }
-
     // writes raw HTML code
     void write_html(const char* html)
     {
@@ -146,16 +141,16 @@ public:
     }
 
 private:
-    explicit html_stream(type_safe::object_ref<std::ostream> out, std::string prefix,
+    explicit html_stream(type_safe::object_ref<output_buffer> out, std::string prefix,
                          std::string extension, std::string closing, bool closing_newl)
     : closing_(std::move(closing)), out_(out), prefix_(std::move(prefix)),
       ext_(std::move(extension)), top_level_(false), closing_newl_(closing_newl)
     {}
 
-    std::string                         closing_;
-    type_safe::object_ref<std::ostream> out_;
-    std::string                         prefix_, ext_;
-    type_safe::flag                     top_level_, closing_newl_;
+    std::string                          closing_;
+    type_safe::object_ref<output_buffer> out_;
+    std::string                          prefix_, ext_;
+    type_safe::flag                      top_level_, closing_newl_;
 };
 
 void write_entity(html_stream& s, const entity& e);
@@ -512,53 +507,83 @@ void write(html_stream& s, const code_block& cb, bool is_synopsis)
     write_children(code, cb);
 }
 
-void write(html_stream& s, const code_block::keyword& text)
+const char* get_highlight_class(entity_kind kind) noexcept
+{
+    switch (kind)
+    {
+    case entity_kind::code_block_keyword:
+        return "kwd";
+    case entity_kind::code_block_identifier:
+        return "typ dec var fun";
+    case entity_kind::code_block_string_literal:
+        return "str";
+    case entity_kind::code_block_int_literal:
+    case entity_kind::code_block_float_literal:
+        return "lit";
+    case entity_kind::code_block_punctuation:
+        return "pun";
+    case entity_kind::code_block_preprocessor:
+        return "pre";
+    default:
+        assert(!static_cast<bool>("not a syntax highlighting entity"));
+        return "";
+    }
+}
+
+void write_highlighted(html_stream& s, entity_kind kind, std::string_view text)
 {
-    s.write_html(R"(<span class="kwd">)");
-    s.write(text.string());
+    s.write_html(R"(<span class=")");
+    s.write_html(get_highlight_class(kind));
+    s.write_html(R"(">)");
+    s.write(text);
     s.write_html("</span>");
 }
 
+void write(html_stream& s, const code_block::keyword& text)
+{
+    write_highlighted(s, text.kind(), text.string());
+}
+
 void write(html_stream& s, const code_block::identifier& text)
 {
-    s.write_html(R"(<span class="typ dec var fun">)");
-    s.write(text.string());
-    s.write_html("</span>");
+    write_highlighted(s, text.kind(), text.string());
 }
 
 void write(html_stream& s, const code_block::string_literal& text)
 {
-    s.write_html(R"(<span class="str">)");
-    s.write(text.string());
-    s.write_html("</span>");
+    write_highlighted(s, text.kind(), text.string());
 }
 
 void write(html_stream& s, const code_block::int_literal& text)
 {
-    s.write_html(R"(<span class="lit">)");
-    s.write(text.string());
-    s.write_html("</span>");
+    write_highlighted(s, text.kind(), text.string());
 }
 
 void write(html_stream& s, const code_block::float_literal& text)
 {
-    s.write_html(R"(<span class="lit">)");
-    s.write(text.string());
-    s.write_html("</span>");
+    write_highlighted(s, text.kind(), text.string());
 }
 
 void write(html_stream& s, const code_block::punctuation& text)
 {
-    s.write_html(R"(<span class="pun">)");
-    s.write(text.string());
-    s.write_html("</span>");
+    write_highlighted(s, text.kind(), text.string());
 }
 
 void write(html_stream& s, const code_block::preprocessor& text)
 {
-    s.write_html(R"(<span class="pre">)");
-    s.write(text.string());
-    s.write_html("</span>");
+    write_highlighted(s, text.kind(), text.string());
+}
+
+void write(html_stream& s, const code_block::token_sequence& tokens)
+{
+    for (auto i = 0u; i != tokens.size(); ++i)
+    {
+        auto token = tokens[i];
+        if (token.kind == entity_kind::text || token.kind == entity_kind::soft_break)
+            s.write(token.string);
+        else
+            write_highlighted(s, token.kind, token.string);
+    }
 }
 
 void write(html_stream& s, const thematic_break&)
@@ -605,6 +630,11 @@ void write(html_stream& s, const hard_break&)
     s.write_html("<br/>\n");
 }
 
+void write(html_stream& s, const borrowed_phrasing& phrasing)
+{
+    write_children(s, phrasing);
+}
+
 void write(html_stream& s, const external_link& link)
 {
     auto a = s.open_link(link.title().c_str(), link.url().as_str().c_str(), false);
@@ -678,6 +708,7 @@ void write_entity(html_stream& s, const entity& e)
         STANDARDESE_DETAIL_HANDLE_CODE_BLOCK(float_literal)
         STANDARDESE_DETAIL_HANDLE_CODE_BLOCK(punctuation)
         STANDARDESE_DETAIL_HANDLE_CODE_BLOCK(preprocessor)
+        STANDARDESE_DETAIL_HANDLE_CODE_BLOCK(token_sequence)
 
         STANDARDESE_DETAIL_HANDLE(thematic_break)
 
@@ -688,6 +719,7 @@ void write_entity(html_stream& s, const entity& e)
         STANDARDESE_DETAIL_HANDLE(verbatim)
         STANDARDESE_DETAIL_HANDLE(soft_break)
         STANDARDESE_DETAIL_HANDLE(hard_break)
+        STANDARDESE_DETAIL_HANDLE(borrowed_phrasing)
 
         STANDARDESE_DETAIL_HANDLE(external_link)
         STANDARDESE_DETAIL_HANDLE(documentation_link)
@@ -715,7 +747,7 @@ void write_entity(html_stream& s, const entity& e)
 generator standardese::markup::html_generator(const std::string& prefix,
                                               const std::string& extension) noexcept
 {
-    return [prefix, extension](std::ostream& out, const entity& e) {
+    return [prefix, extension](output_buffer& out, const entity& e) {
         html_stream s(type_safe::ref(out), prefix, extension);
         write_entity(s, e);
     };
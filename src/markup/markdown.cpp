@@ -6,8 +6,6 @@
 
 #include <cassert>
 #include <cmark-gfm.h>
-#include <ostream>
-#include <sstream>
 
 #include <standardese/markup/block.hpp>
 #include <standardese/markup/code_block.hpp>
@@ -80,12 +78,12 @@ void build_documentation(cmark_node* parent, const options& opt, const documenta
     {
         auto html = cmark_node_new(CMARK_NODE_HTML_BLOCK);
 
-        std::ostringstream stream;
-        stream << "<span id=\"standardese-";
-        detail::write_html_text(stream, doc.id().as_output_str().c_str());
-        stream << "\"></span>\n";
+        output_buffer buffer;
+        buffer << "<span id=\"standardese-";
+        detail::write_html_text(buffer, doc.id().as_output_str());
+        buffer << "\"></span>\n";
 
-        cmark_node_set_literal(html, stream.str().c_str());
+        cmark_node_set_literal(html, buffer.release().c_str());
         cmark_node_append_child(parent, html);
     }
 
@@ -448,6 +446,12 @@ void build(cmark_node* parent, const options&, const code_block::preprocessor& t
     append_code_block_text(parent, text.string());
 }
 
+void build(cmark_node* parent, const options&, const code_block::token_sequence& tokens)
+{
+    // soft breaks are already newlines in the string
+    append_code_block_text(parent, tokens.string());
+}
+
 void build(cmark_node* parent, const options&, const thematic_break&)
 {
     auto node = cmark_node_new(CMARK_NODE_THEMATIC_BREAK);
@@ -520,6 +524,11 @@ void build(cmark_node* parent, const options&, const hard_break&)
     }
 }
 
+void build(cmark_node* parent, const options& opt, const borrowed_phrasing& phrasing)
+{
+    handle_children(parent, opt, phrasing);
+}
+
 cmark_node* build_link(const char* title, const char* url)
 {
     auto node = cmark_node_new(CMARK_NODE_LINK);
@@ -615,6 +624,7 @@ void build_entity(cmark_node* parent, const options& opt, const entity& e)
         STANDARDESE_DETAIL_HANDLE_CODE_BLOCK(float_literal)
         STANDARDESE_DETAIL_HANDLE_CODE_BLOCK(punctuation)
         STANDARDESE_DETAIL_HANDLE_CODE_BLOCK(preprocessor)
+        STANDARDESE_DETAIL_HANDLE_CODE_BLOCK(token_sequence)
 
         STANDARDESE_DETAIL_HANDLE(thematic_break)
 
@@ -625,6 +635,7 @@ void build_entity(cmark_node* parent, const options& opt, const entity& e)
         STANDARDESE_DETAIL_HANDLE(verbatim)
         STANDARDESE_DETAIL_HANDLE(soft_break)
         STANDARDESE_DETAIL_HANDLE(hard_break)
+        STANDARDESE_DETAIL_HANDLE(borrowed_phrasing)
 
         STANDARDESE_DETAIL_HANDLE(external_link)
         STANDARDESE_DETAIL_HANDLE(documentation_link)
@@ -669,11 +680,11 @@ generator standardese::markup::markdown_generator(bool use_html, const std::stri
                                                   const std::string& extension) noexcept
 {
     options opt{prefix, extension, use_html};
-    return [opt](std::ostream& out, const entity& e) {
+    return [opt](output_buffer& out, const entity& e) {
         auto doc = build_entity(opt, e);
 
         auto str = cmark_render_commonmark(doc, CMARK_OPT_NOBREAKS, 0);
-        out << str;
+        out.append(str);
         std::free(str);
 
         cmark_node_free(doc);
@@ -683,11 +694,11 @@ generator standardese::markup::markdown_generator(bool use_html, const std::stri
 generator standardese::markup::text_generator() noexcept
 {
     options opt{"", "txt", false};
-    return [opt](std::ostream& out, const entity& e) {
+    return [opt](output_buffer& out, const entity& e) {
         auto doc = build_entity(opt, e);
 
         auto str = cmark_render_plaintext(doc, CMARK_OPT_NOBREAKS, 0);
-        out << str;
+        out.append(str);
         std::free(str);
 
         cmark_node_free(doc);
@@ -112,3 +112,20 @@ std::unique_ptr<entity> hard_break::do_clone() const
 {
     return build();
 }
+
+entity_kind borrowed_phrasing::do_get_kind() const noexcept
+{
+    return entity_kind::borrowed_phrasing;
+}
+
+void borrowed_phrasing::do_visit(detail::visitor_callback_t cb, void* mem) const
+{
+    for (auto& child : *this)
+        cb(mem, child);
+}
+
+std::unique_ptr<entity> borrowed_phrasing::do_clone() const
+{
+    // the children are shared anyway
+    return std::unique_ptr<entity>(new borrowed_phrasing(begin_, end_));
+}
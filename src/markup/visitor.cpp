@@ -4,6 +4,9 @@
 
 #include <standardese/markup/visitor.hpp>
 
+#include <algorithm>
+#include <vector>
+
 #include <standardese/markup/entity.hpp>
 
 using namespace standardese::markup;
@@ -12,3 +15,36 @@ void detail::call_visit(const entity& e, detail::visitor_callback_t cb, void* me
 {
     e.do_visit(cb, mem);
 }
+
+namespace
+{
+void push_child(void* mem, const entity& child)
+{
+    static_cast<std::vector<const entity*>*>(mem)->push_back(&child);
+}
+} // namespace
+
+bool detail::visit_filtered(const entity& e, const entity_kind_set& kinds,
+                            detail::filtered_visitor_callback_t cb, void* mem)
+{
+    std::vector<const entity*> stack{&e};
+    while (!stack.empty())
+    {
+        auto& cur = *stack.back();
+        stack.pop_back();
+
+        auto kind = cur.kind();
+        if (kinds.contains(kind) && !cb(mem, cur))
+            return false;
+
+        if (get_descendant_kinds(kind).intersects(kinds))
+        {
+            // push the children in reverse, so they are visited in order
+            auto size = stack.size();
+            call_visit(cur, &push_child, &stack);
+            std::reverse(stack.begin() + std::ptrdiff_t(size), stack.end());
+        }
+    }
+
+    return true;
+}
@@ -4,7 +4,8 @@
 
 #include <standardese/markup/generator.hpp>
 
-#include <ostream>
+#include <cassert>
+#include <string_view>
 
 #include <type_safe/flag.hpp>
 #include <type_safe/reference.hpp>
@@ -32,7 +33,7 @@ namespace
 class xml_stream
 {
 public:
-    xml_stream(type_safe::object_ref<std::ostream> out, bool include_attributes = true)
+    xml_stream(type_safe::object_ref<output_buffer> out, bool include_attributes = true)
     : out_(out), newl_(false), attributes_(include_attributes)
     {}
 
@@ -80,29 +81,19 @@ public:
     }
 
     // writes XML escaped text
-    void write(const char* str)
+    void write(std::string_view str)
     {
-        for (auto ptr = str; *ptr; ++ptr)
-        {
-            auto c = *ptr;
-            if (c == '&')
-                *out_ << "&amp;";
-            else if (c == '<')
-                *out_ << "&lt;";
-            else if (c == '>')
-                *out_ << "&gt;";
-            else if (c == '"')
-                *out_ << "&quot;";
-            else if (c == '\'')
-                *out_ << "&apos;";
-            else
-                *out_ << c;
-        }
-    }
-
-    void write(const std::string& str)
-    {
-        write(str.c_str());
+        // characters that don't need escaping are appended in bulk
+        auto begin = str.data();
+        auto end   = begin + str.size();
+        for (auto cur = begin; cur != end; ++cur)
+            if (auto escaped = get_xml_entity(*cur))
+            {
+                out_->append(std::string_view(begin, std::size_t(cur - begin)));
+                out_->append(escaped);
+                begin = cur + 1;
+            }
+        out_->append(std::string_view(begin, std::size_t(end - begin)));
     }
 
     // writes unescaped xml
@@ -112,6 +103,25 @@ public:
     }
 
 private:
+    static const char* get_xml_entity(char c) noexcept
+    {
+        switch (c)
+        {
+        case '&':
+            return "&amp;";
+        case '<':
+            return "&lt;";
+        case '>':
+            return "&gt;";
+        case '"':
+            return "&quot;";
+        case '\'':
+            return "&apos;";
+        default:
+            return nullptr;
+        }
+    }
+
     explicit xml_stream(const xml_stream& parent, std::string closing, bool newl)
     : closing_(closing), out_(parent.out_), newl_(newl), attributes_(parent.attributes_)
     {}
@@ -129,9 +139,9 @@ private:
         }
     }
 
-    std::string                         closing_;
-    type_safe::object_ref<std::ostream> out_;
-    type_safe::flag                     newl_, attributes_;
+    std::string                          closing_;
+    type_safe::object_ref<output_buffer> out_;
+    type_safe::flag                      newl_, attributes_;
 };
 
 void write_entity(xml_stream& s, const entity& e);
@@ -326,46 +336,83 @@ void write(xml_stream& s, const code_block& code)
     write_children(tag, code);
 }
 
-template <typename T>
-void write_cb(xml_stream& s, const char* tag_name, const T& cb)
+const char* get_code_block_tag(entity_kind kind) noexcept
 {
-    auto tag = s.open_tag(xml_stream::inline_tag, tag_name);
-    tag.write(cb.string());
+    switch (kind)
+    {
+    case entity_kind::code_block_keyword:
+        return "code-block-keyword";
+    case entity_kind::code_block_identifier:
+        return "code-block-identifier";
+    case entity_kind::code_block_string_literal:
+        return "code-block-string-literal";
+    case entity_kind::code_block_int_literal:
+        return "code-block-int-literal";
+    case entity_kind::code_block_float_literal:
+        return "code-block-float-literal";
+    case entity_kind::code_block_punctuation:
+        return "code-block-punctuation";
+    case entity_kind::code_block_preprocessor:
+        return "code-block-preprocessor";
+    default:
+        assert(!static_cast<bool>("not a syntax highlighting entity"));
+        return "";
+    }
+}
+
+void write_cb(xml_stream& s, entity_kind kind, std::string_view text)
+{
+    auto tag = s.open_tag(xml_stream::inline_tag, get_code_block_tag(kind));
+    tag.write(text);
 }
 
 void write(xml_stream& s, const code_block::keyword& cb)
 {
-    write_cb(s, "code-block-keyword", cb);
+    write_cb(s, cb.kind(), cb.string());
 }
 
 void write(xml_stream& s, const code_block::identifier& cb)
 {
-    write_cb(s, "code-block-identifier", cb);
+    write_cb(s, cb.kind(), cb.string());
 }
 
 void write(xml_stream& s, const code_block::string_literal& cb)
 {
-    write_cb(s, "code-block-string-literal", cb);
+    write_cb(s, cb.kind(), cb.string());
 }
 
 void write(xml_stream& s, const code_block::int_literal& cb)
 {
-    write_cb(s, "code-block-int-literal", cb);
+    write_cb(s, cb.kind(), cb.string());
 }
 
 void write(xml_stream& s, const code_block::float_literal& cb)
 {
-    write_cb(s, "code-block-float-literal", cb);
+    write_cb(s, cb.kind(), cb.string());
 }
 
 void write(xml_stream& s, const code_block::punctuation& cb)
 {
-    write_cb(s, "code-block-punctuation", cb);
+    write_cb(s, cb.kind(), cb.string());
 }
 
 void write(xml_stream& s, const code_block::preprocessor& cb)
 {
-    write_cb(s, "code-block-preprocessor", cb);
+    write_cb(s, cb.kind(), cb.string());
+}
+
+void write(xml_stream& s, const code_block::token_sequence& tokens)
+{
+    for (auto i = 0u; i != tokens.size(); ++i)
+    {
+        auto token = tokens[i];
+        if (token.kind == entity_kind::text)
+            s.write(token.string);
+        else if (token.kind == entity_kind::soft_break)
+            s.open_tag(xml_stream::line_tag, "soft-break");
+        else
+            write_cb(s, token.kind, token.string);
+    }
 }
 
 void write(xml_stream& s, const brief_section& section)
@@ -434,6 +481,11 @@ void write(xml_stream& s, const hard_break&)
     s.open_tag(xml_stream::line_tag, "hard-break");
 }
 
+void write(xml_stream& s, const borrowed_phrasing& phrasing)
+{
+    write_children(s, phrasing);
+}
+
 void write(xml_stream& s, const external_link& link)
 {
     auto tag
@@ -528,6 +580,7 @@ void write_entity(xml_stream& s, const entity& e)
         STANDARDESE_DETAIL_HANDLE_CODE_BLOCK(float_literal)
         STANDARDESE_DETAIL_HANDLE_CODE_BLOCK(punctuation)
         STANDARDESE_DETAIL_HANDLE_CODE_BLOCK(preprocessor)
+        STANDARDESE_DETAIL_HANDLE_CODE_BLOCK(token_sequence)
 
         STANDARDESE_DETAIL_HANDLE(brief_section)
         STANDARDESE_DETAIL_HANDLE(details_section)
@@ -543,6 +596,7 @@ void write_entity(xml_stream& s, const entity& e)
         STANDARDESE_DETAIL_HANDLE(verbatim)
         STANDARDESE_DETAIL_HANDLE(soft_break)
         STANDARDESE_DETAIL_HANDLE(hard_break)
+        STANDARDESE_DETAIL_HANDLE(borrowed_phrasing)
 
         STANDARDESE_DETAIL_HANDLE(external_link)
         STANDARDESE_DETAIL_HANDLE(documentation_link)
@@ -556,12 +610,12 @@ void write_entity(xml_stream& s, const entity& e)
 generator standardese::markup::xml_generator(bool include_attributes) noexcept
 {
     if (include_attributes)
-        return [](std::ostream& out, const entity& e) {
+        return [](output_buffer& out, const entity& e) {
             xml_stream s(type_safe::ref(out));
             write_entity(s, e);
         };
     else
-        return [](std::ostream& out, const entity& e) {
+        return [](output_buffer& out, const entity& e) {
             xml_stream s(type_safe::ref(out), false);
             write_entity(s, e);
         };
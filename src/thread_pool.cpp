@@ -0,0 +1,155 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/thread_pool.hpp>
+
+#include <algorithm>
+
+using namespace standardese;
+
+namespace
+{
+struct worker_info
+{
+    thread_pool* pool;
+    std::size_t  index;
+};
+
+thread_local worker_info current_worker = {nullptr, 0u};
+
+// orders the heap so the most expensive job is on top,
+// jobs with equal costs are started in order of their addition
+template <class Job>
+bool is_cheaper(const Job& lhs, const Job& rhs)
+{
+    if (lhs.cost != rhs.cost)
+        return lhs.cost < rhs.cost;
+    else
+        return lhs.sequence > rhs.sequence;
+}
+} // namespace
+
+unsigned thread_pool::default_no_threads() noexcept
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+type_safe::optional_ref<thread_pool> thread_pool::current() noexcept
+{
+    return type_safe::opt_ref(current_worker.pool);
+}
+
+thread_pool::thread_pool(unsigned no_threads) : sequence_(0u), no_queued_(0), stop_(false)
+{
+    no_threads = std::max(no_threads, 1u);
+
+    local_.reserve(no_threads);
+    for (auto i = 0u; i != no_threads; ++i)
+        local_.emplace_back(new queue);
+
+    workers_.reserve(no_threads);
+    for (auto i = 0u; i != no_threads; ++i)
+        workers_.emplace_back([this, i] { run(i); });
+}
+
+thread_pool::~thread_pool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        stop_ = true;
+    }
+    wait_cv_.notify_all();
+
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+void thread_pool::push(job j)
+{
+    if (current_worker.pool == this)
+    {
+        // job added by a worker, keep it local
+        auto& local = *local_[current_worker.index];
+
+        std::lock_guard<std::mutex> lock(local.mutex);
+        local.jobs.push_back(std::move(j));
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(global_mutex_);
+        j.sequence = sequence_++;
+        global_.push_back(std::move(j));
+        std::push_heap(global_.begin(), global_.end(), is_cheaper<job>);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        ++no_queued_;
+    }
+    wait_cv_.notify_one();
+}
+
+bool thread_pool::pop(std::size_t worker, job& j)
+{
+    // newest local job first, its data is likely still in the cache
+    {
+        auto&                       local = *local_[worker];
+        std::lock_guard<std::mutex> lock(local.mutex);
+        if (!local.jobs.empty())
+        {
+            j = std::move(local.jobs.back());
+            local.jobs.pop_back();
+            return true;
+        }
+    }
+
+    // then the most expensive job that was added from outside
+    {
+        std::lock_guard<std::mutex> lock(global_mutex_);
+        if (!global_.empty())
+        {
+            std::pop_heap(global_.begin(), global_.end(), is_cheaper<job>);
+            j = std::move(global_.back());
+            global_.pop_back();
+            return true;
+        }
+    }
+
+    // then steal the oldest job of another worker
+    for (auto i = 1u; i != local_.size(); ++i)
+    {
+        auto&                       other = *local_[(worker + i) % local_.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.jobs.empty())
+        {
+            j = std::move(other.jobs.front());
+            other.jobs.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void thread_pool::run(std::size_t worker)
+{
+    current_worker = {this, worker};
+
+    while (true)
+    {
+        job j;
+        if (pop(worker, j))
+        {
+            --no_queued_;
+            // exceptions are stored in the future
+            j.f();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        wait_cv_.wait(lock, [&] { return stop_ || no_queued_ > 0; });
+        if (stop_ && no_queued_ <= 0)
+            break;
+    }
+}
@@ -3,11 +3,15 @@
 // found in the top-level directory of this distribution.
 
 #include <standardese/comment.hpp>
+#include <standardese/doc_entity.hpp>
+#include <standardese/markup/phrasing.hpp>
+#include <standardese/thread_pool.hpp>
 
 #include <fstream>
 
 #include <cppast/cpp_class.hpp>
 #include <cppast/cpp_function.hpp>
+#include <cppast/cpp_namespace.hpp>
 #include <cppast/cpp_template.hpp>
 #include <cppast/visitor.hpp>
 
@@ -186,6 +190,70 @@ TEST_CASE("comment")
             return true;
         });
     }
+    SECTION("remote parallel")
+    {
+        auto file = parse_file({}, "comment_remote_parallel.cpp", R"(
+            /// \entity a
+            /// \module a
+
+            /// \entity b
+            /// \module b
+
+            /// \entity ns::c
+            /// \module c
+
+            /// \entity ns::d(int)
+            /// \module d
+
+            /// \entity ns::d(int).i
+            /// \module i
+
+            /// \entity ns::e::f
+            /// \module f
+
+            struct a {};
+            struct b {};
+
+            namespace ns
+            {
+                struct c {};
+                void d(int i);
+
+                /// \module e
+                struct e
+                {
+                    int f;
+                };
+            }
+            )");
+
+        // the \entity comments are resolved by multiple jobs
+        file_comment_parser parser(test_logger());
+        parser.parse(type_safe::ref(*file));
+
+        thread_pool pool(2u);
+        auto        registry = parser.finish(type_safe::ref(pool));
+
+        auto check_comment = [&](const cppast::cpp_entity& e) {
+            auto comment = registry.get_comment(e);
+            INFO(e.name());
+            REQUIRE(comment);
+            REQUIRE(e.name() == comment.value().metadata().module());
+        };
+
+        cppast::visit(*file, [&](const cppast::cpp_entity& e, const cppast::visitor_info&) {
+            // neither has a comment
+            if (e.kind() == cppast::cpp_file::kind() || e.kind() == cppast::cpp_namespace::kind())
+                return true;
+
+            check_comment(e);
+            if (cppast::is_function(e.kind()))
+                for (auto& param : static_cast<const cppast::cpp_function_base&>(e).parameters())
+                    check_comment(param);
+
+            return true;
+        });
+    }
     SECTION("member groups")
     {
         auto file = parse_file({}, "comment_member_groups.cpp", R"(
@@ -251,6 +319,61 @@ TEST_CASE("comment")
         REQUIRE(bar);
         REQUIRE(bar.value().metadata().synopsis() == "bar");
     }
+    SECTION("blacklist")
+    {
+        auto file = parse_file({}, "comment_blacklist.cpp", R"(
+            /// \module a
+            void a();
+
+            /// \module b
+            namespace detail
+            {
+                /// \module c
+                void c();
+            }
+
+            class d
+            {
+                /// \module e
+                void e();
+
+            public:
+                /// \module f
+                void f();
+            };
+
+            /// \module g
+            static_assert(true, "");
+
+            /// \entity detail::c
+            /// \module h
+            )");
+
+        entity_blacklist blacklist;
+        blacklist.blacklist_namespace("detail");
+
+        // the test logger fails if the comment for detail::c is reported as unmatched
+
+        file_comment_parser parser(test_logger(), comment::config(), type_safe::ref(blacklist));
+        parser.parse(type_safe::ref(*file));
+        auto registry = parser.finish();
+
+        auto commented = 0;
+        cppast::visit(*file, [&](const cppast::cpp_entity& e, const cppast::visitor_info& info) {
+            if (info.event == cppast::visitor_info::container_entity_exit)
+                return;
+
+            auto comment = registry.get_comment(e);
+            if (e.name() == "a" || e.name() == "f")
+            {
+                REQUIRE(comment);
+                ++commented;
+            }
+            else
+                REQUIRE(!comment);
+        });
+        REQUIRE(commented == 2);
+    }
     SECTION("free file comments")
     {
         auto file = parse_file({}, "file_comment.hpp", R"(
@@ -264,6 +387,103 @@ TEST_CASE("comment")
         auto comments = parser.finish();
     }
 
+    SECTION("merge")
+    {
+        auto file = parse_file({}, "comment_merge.cpp", R"(
+            void a();
+            void b();
+            )");
+        auto& a = *file->begin();
+        auto& b = *std::next(file->begin());
+
+        auto documented = [](const char* brief) {
+            return comment::doc_comment(comment::metadata(),
+                                        markup::brief_section::builder()
+                                            .add_child(markup::text::build(brief))
+                                            .finish(),
+                                        {});
+        };
+
+        class counting_logger : public cppast::diagnostic_logger
+        {
+        public:
+            mutable int count = 0;
+
+        private:
+            bool do_log(const char*, const cppast::diagnostic&) const override
+            {
+                ++count;
+                return true;
+            }
+        } logger;
+
+        comment_registry registry;
+        registry.register_comment(type_safe::ref(a), documented("first"));
+        registry.register_comment("m", documented("first"));
+        registry.add_to_group("g", type_safe::ref(b));
+
+        comment_registry other;
+        other.register_comment(type_safe::ref(a), documented("second"));
+        other.register_comment(type_safe::ref(b), documented("second"));
+        other.register_comment("m", documented("second"));
+        other.add_to_group("g", type_safe::ref(a));
+
+        registry.merge(std::move(other), logger);
+
+        auto brief = [](type_safe::optional_ref<const comment::doc_comment> comment) {
+            auto& section = comment.value().brief_section().value();
+            return static_cast<const markup::text&>(*section.begin()).string();
+        };
+        // the duplicate comments of a and m are dropped
+        REQUIRE(logger.count == 2);
+        REQUIRE(brief(registry.get_comment(a)) == "first");
+        REQUIRE(brief(registry.get_comment(b)) == "second");
+        REQUIRE(brief(registry.get_comment("m")) == "first");
+
+        registry.sort_groups();
+        auto group = registry.lookup_group("g");
+        REQUIRE((group.size() == 2u));
+        REQUIRE(&*group[0] == &a);
+        REQUIRE(&*group[1] == &b);
+    }
+
+    SECTION("identical comments")
+    {
+        auto file = parse_file({}, "comment_identical.cpp", R"(
+            /// \module a
+            void a(int);
+
+            /// \module a
+            void a(float);
+
+            /// \module a
+            void a(double);
+
+            /// \module a
+            ///
+            /// \param b
+            /// \module b
+            void a(long b);
+            )");
+
+        file_comment_parser parser(test_logger());
+        parser.parse(type_safe::ref(*file));
+
+        // the result is only cached once the text was parsed twice
+        auto statistics = parser.statistics();
+        REQUIRE(statistics.comments == 4u);
+        REQUIRE(statistics.reused == 1u);
+
+        // every entity gets its own copy
+        auto registry = parser.finish();
+        test_comments(registry, *file);
+        REQUIRE(&registry.get_comment(*std::next(file->begin())).value()
+                != &registry.get_comment(*std::next(file->begin(), 2)).value());
+        test_comments(registry, static_cast<const cppast::cpp_function_base&>(
+                                    *std::next(file->begin(), 3))
+                                    .parameters());
+    }
+
     SECTION("Group Uncommented Members")
     {
         auto file = parse_file({}, "groups.hpp", R"(
@@ -286,6 +506,77 @@ TEST_CASE("comment")
         const auto& group = comments.lookup_group("Arithmetic");
         CHECK(static_cast<size_t>(group.size()) == 2);
     }
+
+    SECTION("Group Uncommented Members with remote comments")
+    {
+        auto file = parse_file({}, "groups_remote.hpp", R"(
+            struct S {
+                /// \group a
+                void a();
+                void b();
+                void c();
+                void d();
+                void e();
+            };
+
+            /// \entity S::b()
+            /// Documented remotely.
+
+            /// \entity S::d()
+            /// \group d
+            )");
+
+        comment::config::options options;
+        options.group_uncommented = true;
+        file_comment_parser parser(test_logger(), comment::config(options));
+        parser.parse(type_safe::ref(*file));
+        auto comments = parser.finish();
+
+        auto names = [&](const char* group) {
+            std::vector<std::string> result;
+            for (auto entity : comments.lookup_group(group))
+                result.push_back(entity->name());
+            return result;
+        };
+
+        // b is documented remotely, so neither b nor c are grouped with a
+        REQUIRE(names("a") == std::vector<std::string>{"a"});
+        // d is grouped remotely, so e is grouped with it
+        REQUIRE(names("d") == std::vector<std::string>{"d", "e"});
+    }
+
+    SECTION("Group Uncommented Members with excluded members")
+    {
+        auto file = parse_file({}, "groups_excluded.hpp", R"(
+            struct S {
+                /// \group a
+                void a();
+
+            private:
+                void b();
+
+            public:
+                void c();
+            };
+            )");
+
+        entity_blacklist blacklist;
+
+        comment::config::options options;
+        options.group_uncommented = true;
+        file_comment_parser parser(test_logger(), comment::config(options),
+                                   type_safe::ref(blacklist));
+        parser.parse(type_safe::ref(*file));
+        auto comments = parser.finish();
+
+        std::vector<std::string> names;
+        for (auto entity : comments.lookup_group("a"))
+            names.push_back(entity->name());
+
+        // b is excluded, so it is skipped and c is grouped with a
+        REQUIRE(names == std::vector<std::string>{"a", "c"});
+        REQUIRE(!comments.get_comment(get_named_entity(*file, "b")));
+    }
 }
 
 }
@@ -1107,7 +1107,56 @@ TEST_CASE("Standardese Commands", "[comment]")
     SECTION("Section Commands")
     {
         // We should test all the section commands here.
+
+        SECTION("Section Commands can be Changed Through Configuration")
+        {
+            standardese::comment::config::options options;
+            // This pattern does not start with a fixed prefix.
+            options.command_patterns.push_back("returns|=RETURNS:|Returns:");
+
+            const auto parsed = parse(R"(
+                The brief.
+
+                \returns The first return value.
+                \end
+                RETURNS: The second return value.
+                \end
+                Returns: The third return value.
+                )", options);
+
+            CHECK_SECTIONS_EQUIVALENT_TO(parsed, {R"(
+                <inline-section name="Return values">The first return value.</inline-section>
+                )", R"(
+                <inline-section name="Return values">The second return value.</inline-section>
+                )", R"(
+                <inline-section name="Return values">The third return value.</inline-section>
+                )"});
+        }
     }
 }
 
+TEST_CASE("Command Detection", "[comment][!benchmark]")
+{
+    // Most lines of a comment are not commands,
+    // they should be rejected without trying every command pattern.
+    std::string comment = "The brief.\n\n";
+    for (auto i = 0; i != 100; ++i)
+        comment += "A line of the details that is not a command.\n";
+    comment += "\\returns Something.\n";
+
+    const parser default_parser;
+    BENCHMARK("Default Command Patterns")
+    {
+        return standardese::comment::parse(default_parser, comment, true);
+    };
+
+    standardese::comment::config::options options;
+    options.command_patterns.push_back("returns|=RETURNS:|Returns:");
+    const parser custom_parser{standardese::comment::config(options)};
+    BENCHMARK("Custom Command Pattern without Prefix")
+    {
+        return standardese::comment::parse(custom_parser, comment, true);
+    };
+}
+
 }
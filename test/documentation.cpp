@@ -180,6 +180,46 @@ class X {};
 
     }
 
+    SECTION("fast preprocessing")
+    {
+        // the included file is not preprocessed, so it must not define macros used by the header
+        std::ofstream("documentation__fast_dependency.hpp") << R"(
+#pragma once
+
+namespace dependency
+{
+    struct type {};
+}
+)";
+
+        auto source = R"(
+#include "documentation__fast_dependency.hpp"
+
+#define FAST_TYPE dependency::type
+
+/// A function.
+/// \returns A type.
+FAST_TYPE fast(const dependency::type& t);
+)";
+
+        auto generate = [&](bool fast_preprocessing) {
+            comment_registry         fast_comments;
+            cppast::cpp_entity_index fast_index;
+
+            auto parsed = parse_file(fast_index, "documentation__fast.hpp", source,
+                                     fast_preprocessing);
+            fast_comments.merge(parse_comments(*parsed), *test_logger());
+            auto file = build_doc_entities(fast_comments, fast_index, std::move(parsed));
+
+            auto doc = generate_documentation({}, {}, fast_index, *file);
+            return markup::as_xml(*doc);
+        };
+
+        auto result = generate(false);
+        REQUIRE(result.find("A function.") != std::string::npos);
+        REQUIRE(generate(true) == result);
+    }
+
 
     SECTION("inlines")
     {
@@ -0,0 +1,48 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/interned_string.hpp>
+
+#include "../external/catch/single_include/catch2/catch.hpp"
+
+using namespace standardese;
+
+TEST_CASE("interned_string")
+{
+    SECTION("empty")
+    {
+        interned_string empty;
+        REQUIRE(empty.empty());
+        REQUIRE(empty.id() == 0u);
+        REQUIRE(empty.str().empty());
+        REQUIRE(empty == interned_string(""));
+    }
+    SECTION("equality")
+    {
+        interned_string a("interned_string-a");
+        interned_string b(std::string("interned_string-") + "a");
+        interned_string c("interned_string-c");
+
+        REQUIRE(!a.empty());
+        REQUIRE(a.str() == "interned_string-a");
+        REQUIRE(a == b);
+        REQUIRE(a.id() == b.id());
+        REQUIRE(&a.str() == &b.str());
+        REQUIRE(a != c);
+        REQUIRE(std::hash<interned_string>{}(a) == std::hash<interned_string>{}(b));
+    }
+    SECTION("lookup")
+    {
+        REQUIRE(!interned_string::lookup("interned_string-never-added"));
+        REQUIRE(!interned_string::lookup("interned_string-never-added"));
+
+        interned_string added("interned_string-added");
+        auto            result = interned_string::lookup("interned_string-added");
+        REQUIRE(result);
+        REQUIRE(result.value() == added);
+
+        REQUIRE(interned_string::lookup(""));
+        REQUIRE(interned_string::lookup("").value().empty());
+    }
+}
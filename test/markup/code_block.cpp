@@ -6,6 +6,7 @@
 
 #include "../external/catch/single_include/catch2/catch.hpp"
 
+#include <standardese/markup/entity_kind.hpp>
 #include <standardese/markup/generator.hpp>
 
 using namespace standardese::markup;
@@ -96,3 +97,47 @@ void foo();
 ```
 )");
 }
+
+TEST_CASE("code-block::token-sequence", "[markup]")
+{
+    code_block::token_sequence::builder tokens;
+    REQUIRE(tokens.empty());
+    tokens.add_token(entity_kind::code_block_keyword, "void");
+    tokens.add_text(" ");
+    tokens.add_token(entity_kind::code_block_identifier, "foo");
+    tokens.add_token(entity_kind::code_block_punctuation, "();");
+    tokens.add_soft_break();
+    tokens.add_text("  ");
+    tokens.add_text("");
+    tokens.add_text("<a>");
+    tokens.add_soft_break();
+
+    auto seq = tokens.finish();
+    REQUIRE(tokens.empty());
+    REQUIRE(seq->string() == "void foo();\n  <a>\n");
+    REQUIRE(seq->size() == 7u);
+    REQUIRE((*seq)[5u].kind == entity_kind::text);
+    REQUIRE((*seq)[5u].string == "  <a>");
+
+    auto html = R"(<pre><code id="standardese-foo" class="standardese-language-cpp"><span class="kwd">void</span> <span class="typ dec var fun">foo</span><span class="pun">();</span>
+  &lt;a&gt;
+</code></pre>
+)";
+
+    auto xml = R"(<code-block id="foo" language="cpp"><code-block-keyword>void</code-block-keyword> <code-block-identifier>foo</code-block-identifier><code-block-punctuation>();</code-block-punctuation><soft-break></soft-break>
+  &lt;a&gt;<soft-break></soft-break>
+</code-block>
+)";
+
+    code_block::builder builder(block_id("foo"), "cpp");
+    builder.add_child(std::move(seq));
+
+    auto ptr = builder.finish();
+    REQUIRE(as_html(*ptr) == html);
+    REQUIRE(as_xml(*ptr->clone()) == xml);
+    REQUIRE(render(markdown_generator(false, "", "md"), *ptr) == R"(``` cpp
+void foo();
+  <a>
+```
+)");
+}
@@ -83,3 +83,23 @@ TEST_CASE("template_document", "[markup]")
     REQUIRE(as_xml(*doc) == xml);
     REQUIRE(as_markdown(*doc) == md);
 }
+
+TEST_CASE("document arena", "[markup]")
+{
+    std::unique_ptr<paragraph> kept;
+    {
+        subdocument::builder builder("Hello World!", "my-file");
+        builder.add_child(paragraph::builder(block_id("a")).add_child(text::build("foo")).finish());
+
+        kept = paragraph::builder(block_id("b")).add_child(text::build("bar")).finish();
+
+        auto doc = builder.finish();
+        REQUIRE(as_markdown(*doc) == "foo\n");
+    }
+    // the arena is kept alive by the remaining entities
+    REQUIRE(as_markdown(*kept) == "bar\n");
+
+    // outside of a builder entities are allocated on the heap
+    auto heap = text::build("baz");
+    REQUIRE(heap->string() == "baz");
+}
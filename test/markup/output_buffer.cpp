@@ -0,0 +1,52 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/markup/output_buffer.hpp>
+
+#include "../external/catch/single_include/catch2/catch.hpp"
+
+#include <sstream>
+
+#include <standardese/markup/generator.hpp>
+#include <standardese/markup/paragraph.hpp>
+#include <standardese/markup/phrasing.hpp>
+
+using namespace standardese::markup;
+
+TEST_CASE("output_buffer", "[markup]")
+{
+    output_buffer buffer(16u);
+    REQUIRE(buffer.size() == 0u);
+
+    buffer.append("Hello");
+    buffer << ' ' << std::string("World") << '!';
+    REQUIRE(buffer.view() == "Hello World!");
+    REQUIRE(buffer.size() == 12u);
+
+    buffer.clear();
+    REQUIRE(buffer.view().empty());
+
+    buffer << "<a & b>";
+    REQUIRE(buffer.release() == "<a & b>");
+    REQUIRE(buffer.view().empty());
+
+    SECTION("generators")
+    {
+        paragraph::builder builder;
+        builder.add_child(text::build("a < b & c"));
+        auto ptr = builder.finish();
+
+        output_buffer html;
+        html_generator("", "html")(html, *ptr);
+        REQUIRE(html.view() == "<p>a &lt; b &amp; c</p>\n");
+
+        output_buffer xml;
+        xml_generator()(xml, *ptr);
+        REQUIRE(xml.view() == "<paragraph>a &lt; b &amp; c</paragraph>\n");
+
+        std::ostringstream stream;
+        render(html_generator("", "html"), stream, *ptr);
+        REQUIRE(stream.str() == as_html(*ptr));
+    }
+}
@@ -100,3 +100,20 @@ TEST_CASE("hard_break", "[markup]")
     REQUIRE(as_xml(*hard_break::build()) == "<hard-break></hard-break>\n");
     REQUIRE(as_markdown(*hard_break::build()) == "  \n");
 }
+
+TEST_CASE("borrowed_phrasing", "[markup]")
+{
+    auto owner = emphasis::builder()
+                     .add_child(text::build("Hello "))
+                     .add_child(strong_emphasis::build("World"))
+                     .finish();
+
+    auto borrowed = borrowed_phrasing::build(*owner);
+    REQUIRE(&*borrowed->begin() == &*owner->begin());
+    REQUIRE(&borrowed->begin()->parent().value() == owner.get());
+
+    auto a = code::builder().add_child(std::move(borrowed)).finish();
+    auto b = a->clone();
+    REQUIRE(as_html(*b) == "<code>Hello <strong>World</strong></code>");
+    REQUIRE(as_xml(*b) == "<code>Hello <strong-emphasis>World</strong-emphasis></code>");
+}
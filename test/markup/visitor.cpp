@@ -0,0 +1,161 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/markup/visitor.hpp>
+
+#include <vector>
+
+#include "../external/catch/single_include/catch2/catch.hpp"
+
+#include <standardese/markup/document.hpp>
+#include <standardese/markup/entity_kind.hpp>
+#include <standardese/markup/link.hpp>
+#include <standardese/markup/list.hpp>
+#include <standardese/markup/paragraph.hpp>
+#include <standardese/markup/phrasing.hpp>
+
+using namespace standardese::markup;
+
+namespace
+{
+std::unique_ptr<paragraph> build_paragraph(const char* dest)
+{
+    paragraph::builder builder(block_id(""));
+    builder.add_child(text::build("see "));
+    builder.add_child(
+        emphasis::builder().add_child(documentation_link::builder(dest).finish()).finish());
+    return builder.finish();
+}
+
+// an emphasis that counts how often its children are visited
+class counting_emphasis final : public phrasing_entity
+{
+public:
+    static std::unique_ptr<counting_emphasis> build(std::unique_ptr<phrasing_entity> child,
+                                                    unsigned&                        entered)
+    {
+        return std::unique_ptr<counting_emphasis>(
+            new counting_emphasis(std::move(child), entered));
+    }
+
+private:
+    counting_emphasis(std::unique_ptr<phrasing_entity> child, unsigned& entered)
+    : child_(std::move(child)), entered_(&entered)
+    {
+        set_ownership(*child_);
+    }
+
+    entity_kind do_get_kind() const noexcept override
+    {
+        return entity_kind::emphasis;
+    }
+
+    void do_visit(detail::visitor_callback_t cb, void* mem) const override
+    {
+        ++*entered_;
+        cb(mem, *child_);
+    }
+
+    std::unique_ptr<entity> do_clone() const override
+    {
+        return build(detail::unchecked_downcast<phrasing_entity>(child_->clone()), *entered_);
+    }
+
+    std::unique_ptr<phrasing_entity> child_;
+    unsigned*                        entered_;
+};
+
+std::unique_ptr<paragraph> build_counting_paragraph(const char* dest, unsigned& entered)
+{
+    paragraph::builder builder(block_id(""));
+    builder.add_child(text::build("see "));
+    builder.add_child(
+        counting_emphasis::build(documentation_link::builder(dest).finish(), entered));
+    return builder.finish();
+}
+
+std::string visit_links(const entity& e, const entity_kind_set& kinds, unsigned max = 100u)
+{
+    std::string result;
+    visit(e, kinds, [&](const entity& child) {
+        if (child.kind() == entity_kind::documentation_link)
+            result += static_cast<const documentation_link&>(child)
+                          .unresolved_destination()
+                          .value();
+        else
+            result += "|";
+        return result.size() < max;
+    });
+    return result;
+}
+} // namespace
+
+TEST_CASE("visit", "[markup]")
+{
+    subdocument::builder builder("Hello World!", "my-file");
+    builder.add_child(build_paragraph("a"));
+    builder.add_child(unordered_list::builder(block_id(""))
+                          .add_item(list_item::build(build_paragraph("b")))
+                          .add_item(list_item::build(build_paragraph("c")))
+                          .finish());
+    builder.add_child(build_paragraph("d"));
+    auto doc = builder.finish();
+
+    SECTION("all")
+    {
+        auto count = 0u;
+        visit(*doc, [&](const entity&) { ++count; });
+
+        auto filtered = 0u;
+        REQUIRE(visit(*doc, entity_kind_set::all(), [&](const entity&) { ++filtered; }));
+        REQUIRE(filtered == count);
+    }
+    SECTION("links")
+    {
+        REQUIRE(visit_links(*doc, {entity_kind::documentation_link}) == "abcd");
+        REQUIRE(visit_links(*doc, {entity_kind::documentation_link, entity_kind::list_item})
+                == "a|b|cd");
+    }
+    SECTION("early exit")
+    {
+        REQUIRE(visit_links(*doc, {entity_kind::documentation_link}, 2u) == "ab");
+        REQUIRE(!visit(*doc, {entity_kind::paragraph}, [](const entity&) { return false; }));
+    }
+    SECTION("skipped subtrees")
+    {
+        auto                 entered = 0u;
+        subdocument::builder counting("Counting", "counting-file");
+        counting.add_child(build_counting_paragraph("a", entered));
+        counting.add_child(unordered_list::builder(block_id(""))
+                               .add_item(list_item::build(build_counting_paragraph("b", entered)))
+                               .finish());
+        counting.add_child(build_counting_paragraph("c", entered));
+        auto counting_doc = counting.finish();
+
+        std::vector<entity_kind> visited;
+        auto                     record = [&](const entity& e) { visited.push_back(e.kind()); };
+
+        // paragraphs can't contain lists, so their children are never entered
+        REQUIRE(visit(*counting_doc, {entity_kind::unordered_list}, record));
+        REQUIRE(visited == std::vector<entity_kind>{entity_kind::unordered_list});
+        REQUIRE(entered == 0u);
+
+        visited.clear();
+        REQUIRE(visit(*counting_doc, {entity_kind::documentation_link}, record));
+        REQUIRE(visited.size() == 3u);
+        REQUIRE(entered == 3u);
+
+        visited.clear();
+        entered = 0u;
+        REQUIRE(visit(*counting_doc, {entity_kind::list_item}, record));
+        REQUIRE(visited == std::vector<entity_kind>{entity_kind::list_item});
+        REQUIRE(entered == 0u);
+
+        // paragraphs can't contain lists
+        REQUIRE(!get_descendant_kinds(entity_kind::paragraph).contains(entity_kind::list_item));
+        REQUIRE(get_descendant_kinds(entity_kind::paragraph)
+                    .contains(entity_kind::documentation_link));
+        REQUIRE(!get_descendant_kinds(entity_kind::text).intersects(entity_kind_set::all()));
+    }
+}
@@ -19,11 +19,13 @@
 #include "util/indent.hpp"
 
 inline std::unique_ptr<cppast::cpp_file> parse_file(const cppast::cpp_entity_index& idx,
-                                                    const char* name, const char* content)
+                                                    const char* name, const char* content,
+                                                    bool fast_preprocessing = false)
 {
     static cppast::libclang_compile_config config;
     static cppast::libclang_parser         parser(test_logger());
     config.set_flags(cppast::cpp_standard::cpp_latest);
+    config.fast_preprocessing(fast_preprocessing);
 
     std::ofstream file(name);
     file << standardese::test::util::unindent(content);
@@ -80,7 +82,7 @@ inline std::unique_ptr<standardese::doc_cpp_file> build_doc_entities(
     blacklist = {}, bool hide_uncommented = false)
 {
     auto file = parse_file(index, name, source);
-    comments.merge(parse_comments(*file));
+    comments.merge(parse_comments(*file), *test_logger());
     return build_doc_entities(comments, index, std::move(file), blacklist, hide_uncommented);
 }
 
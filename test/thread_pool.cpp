@@ -0,0 +1,78 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <standardese/thread_pool.hpp>
+
+#include "../external/catch/single_include/catch2/catch.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+using namespace standardese;
+
+TEST_CASE("thread_pool")
+{
+    SECTION("results and exceptions")
+    {
+        thread_pool pool(4u);
+        REQUIRE(pool.size() == 4u);
+        REQUIRE(!thread_pool::current());
+
+        std::vector<std::future<int>> futures;
+        for (auto i = 0; i != 100; ++i)
+            futures.push_back(pool.add_job([i] { return i * i; }));
+        for (auto i = 0; i != 100; ++i)
+            REQUIRE(futures[std::size_t(i)].get() == i * i);
+
+        auto error = pool.add_job([]() -> int { throw std::runtime_error("error"); });
+        REQUIRE_THROWS_AS(error.get(), std::runtime_error);
+    }
+    SECTION("cost ordering")
+    {
+        thread_pool pool(1u);
+
+        // block the only worker until all jobs are added
+        std::promise<void> start;
+        auto               blocker = pool.add_job([&] { start.get_future().wait(); });
+
+        std::mutex       mutex;
+        std::vector<int> order;
+        std::vector<std::future<void>> futures;
+        for (auto cost : {1, 3, 2, 3})
+            futures.push_back(pool.add_job(
+                [&, cost] {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    order.push_back(cost);
+                },
+                cost));
+
+        start.set_value();
+        blocker.get();
+        for (auto& future : futures)
+            future.get();
+        REQUIRE(order == std::vector<int>{3, 3, 2, 1});
+    }
+    SECTION("nested jobs")
+    {
+        thread_pool pool(2u);
+
+        // assertions are only checked on the main thread
+        auto outer = pool.add_job([] {
+            std::vector<std::future<int>> inner;
+            auto                          current = thread_pool::current();
+            if (current)
+                for (auto i = 0; i != 10; ++i)
+                    inner.push_back(current.value().add_job([i] { return i; }));
+            return std::make_pair(bool(current), std::move(inner));
+        });
+
+        auto result = outer.get();
+        REQUIRE(result.first);
+
+        auto sum = 0;
+        for (auto& future : result.second)
+            sum += future.get();
+        REQUIRE(sum == 45);
+    }
+}
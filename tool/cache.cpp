@@ -0,0 +1,282 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include "cache.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unordered_set>
+
+#include <cppast/cpp_preprocessor.hpp>
+#include <cppast/visitor.hpp>
+
+#include "generator.hpp"
+
+using namespace standardese_tool;
+
+content_hash standardese_tool::hash_bytes(const char* data, std::size_t size,
+                                          content_hash seed) noexcept
+{
+    // FNV-1a
+    auto hash = seed ^ 14695981039346656037ull;
+    for (auto end = data + size; data != end; ++data)
+    {
+        hash ^= static_cast<unsigned char>(*data);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+content_hash standardese_tool::hash_file(const fs::path& path, content_hash seed)
+{
+    seed = hash_string(path.generic_string(), seed);
+
+    // hashed in one go, so the hash is the same as the one of the content written to the file
+    std::ifstream file(path.string(), std::ios_base::binary);
+    std::string   content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return hash_string(content, seed);
+}
+
+namespace
+{
+constexpr auto cache_file_name = "standardese.cache";
+constexpr auto cache_header    = "standardese-cache 2";
+
+std::string get_key(const fs::path& path)
+{
+    boost::system::error_code ec;
+    auto                      canonical = fs::canonical(path, ec);
+    return (ec ? path : canonical).generic_string();
+}
+
+struct include_name
+{
+    std::string name;
+    bool        quoted;
+};
+
+// returns the names of all files included by the given file
+// conditional compilation is ignored, so it might return more than are actually included
+std::vector<include_name> read_includes(const std::string& path)
+{
+    std::vector<include_name> result;
+
+    std::ifstream file(path);
+    std::string   line;
+    while (std::getline(file, line))
+    {
+        auto skip_ws = [&](std::size_t pos) { return line.find_first_not_of(" \t", pos); };
+
+        auto pos = skip_ws(0u);
+        if (pos == std::string::npos || line[pos] != '#')
+            continue;
+        pos = skip_ws(pos + 1u);
+        if (pos == std::string::npos || line.compare(pos, 7u, "include") != 0)
+            continue;
+        pos = skip_ws(pos + 7u);
+        if (pos == std::string::npos || (line[pos] != '"' && line[pos] != '<'))
+            continue;
+
+        auto quoted = line[pos] == '"';
+        auto end    = line.find(quoted ? '"' : '>', pos + 1u);
+        if (end != std::string::npos)
+            result.push_back({line.substr(pos + 1u, end - pos - 1u), quoted});
+    }
+
+    return result;
+}
+} // namespace
+
+file_cache::file_cache(fs::path directory, content_hash config_hash,
+                       std::vector<fs::path> include_dirs)
+: directory_(std::move(directory)), config_hash_(config_hash),
+  include_dirs_(std::move(include_dirs))
+{
+    std::ifstream in((directory_ / cache_file_name).string());
+    std::string   line;
+    if (!std::getline(in, line) || line != cache_header)
+        // no cache or incompatible version
+        return;
+
+    entry* cur = nullptr;
+    while (std::getline(in, line))
+    {
+        std::istringstream stream(line);
+        std::string        kind;
+        stream >> kind;
+        if (kind == "file")
+        {
+            entry e;
+            stream >> std::hex >> e.hash >> std::dec >> e.parse_time;
+
+            std::string path;
+            stream.ignore(1);
+            if (!stream || !std::getline(stream, path))
+                throw std::runtime_error("corrupted cache file in '" + directory_.generic_string()
+                                         + "'");
+
+            cur = &(previous_[std::move(path)] = std::move(e));
+        }
+        else if (kind == "include" && cur)
+        {
+            std::string path;
+            stream.ignore(1);
+            std::getline(stream, path);
+            cur->includes.push_back(std::move(path));
+        }
+        else if (kind == "output")
+        {
+            content_hash hash;
+            stream >> std::hex >> hash >> std::dec;
+
+            std::string path;
+            stream.ignore(1);
+            if (!stream || !std::getline(stream, path))
+                throw std::runtime_error("corrupted cache file in '" + directory_.generic_string()
+                                         + "'");
+            previous_outputs_[std::move(path)] = hash;
+        }
+    }
+}
+
+bool file_cache::is_unchanged(const fs::path& path) const
+{
+    auto key  = get_key(path);
+    auto iter = previous_.find(key);
+    return iter != previous_.end() && iter->second.hash == get_hash(key, iter->second.includes);
+}
+
+bool file_cache::is_unchanged(const std::vector<input_file>& files) const
+{
+    if (files.size() != previous_.size())
+        return false;
+
+    for (auto& file : files)
+        if (!is_unchanged(file.path))
+            return false;
+
+    // the outputs might have been modified or deleted in the meantime
+    if (previous_outputs_.empty())
+        return false;
+    for (auto& pair : previous_outputs_)
+    {
+        boost::system::error_code ec;
+        if (!fs::exists(pair.first, ec) || hash_file(pair.first, 0u) != pair.second)
+            return false;
+    }
+    return true;
+}
+
+type_safe::optional<double> file_cache::parse_time(const fs::path& path) const
+{
+    auto iter = previous_.find(get_key(path));
+    if (iter == previous_.end())
+        return type_safe::nullopt;
+    return iter->second.parse_time;
+}
+
+void file_cache::record(const fs::path& path, const cppast::cpp_file& file, double parse_time)
+{
+    entry e;
+    e.parse_time = parse_time;
+    e.includes   = get_include_closure(file);
+
+    auto key = get_key(path);
+    e.hash   = get_hash(key, e.includes);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_[std::move(key)] = std::move(e);
+}
+
+void file_cache::record_output(const fs::path& path, std::string_view content)
+{
+    auto key  = get_key(path);
+    // same as hash_file() of the written file
+    auto hash = hash_bytes(content.data(), content.size(), hash_string(key, 0u));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_outputs_[std::move(key)] = hash;
+}
+
+void file_cache::save() const
+{
+    fs::create_directories(directory_);
+
+    // write to a temporary file first, so an interrupted run does not leave a corrupted cache
+    auto          tmp = directory_ / (std::string(cache_file_name) + ".tmp");
+    std::ofstream out(tmp.string());
+    out << cache_header << '\n';
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& pair : current_)
+    {
+        out << "file " << std::hex << pair.second.hash << std::dec << ' '
+            << pair.second.parse_time << ' ' << pair.first << '\n';
+        for (auto& include : pair.second.includes)
+            out << "include " << include << '\n';
+    }
+    for (auto& pair : current_outputs_)
+        out << "output " << std::hex << pair.second << std::dec << ' ' << pair.first << '\n';
+
+    out.close();
+    if (!out)
+        throw std::runtime_error("unable to write cache file in '" + directory_.generic_string()
+                                 + "'");
+    fs::rename(tmp, directory_ / cache_file_name);
+}
+
+content_hash file_cache::get_hash(const std::string&              path,
+                                  const std::vector<std::string>& includes) const
+{
+    auto hash = hash_file(path, config_hash_);
+    for (auto& include : includes)
+        hash = hash_file(include, hash);
+    return hash;
+}
+
+std::vector<std::string> file_cache::get_include_closure(const cppast::cpp_file& file) const
+{
+    std::vector<std::string>        result;
+    std::unordered_set<std::string> seen;
+    auto                            add = [&](const fs::path& path) {
+        auto key = get_key(path);
+        if (seen.insert(key).second)
+            result.push_back(std::move(key));
+    };
+
+    // includes can be nested in namespaces or extern "C" blocks
+    cppast::visit(file, [&](const cppast::cpp_entity& e, const cppast::visitor_info&) {
+        if (e.kind() == cppast::cpp_entity_kind::include_directive_t)
+        {
+            auto& include = static_cast<const cppast::cpp_include_directive&>(e);
+            if (!include.full_path().empty())
+                add(include.full_path());
+        }
+        return true;
+    });
+
+    // the parser only reports the includes of the file itself,
+    // so the includes of the headers are searched the same way the preprocessor does
+    // system headers that are not in an include directory are not considered
+    for (auto i = 0u; i != result.size(); ++i)
+    {
+        auto directory = fs::path(result[i]).parent_path();
+        for (auto& include : read_includes(result[i]))
+        {
+            boost::system::error_code ec;
+            if (include.quoted && fs::is_regular_file(directory / include.name, ec))
+                add(directory / include.name);
+            else
+                for (auto& include_dir : include_dirs_)
+                    if (fs::is_regular_file(include_dir / include.name, ec))
+                    {
+                        add(include_dir / include.name);
+                        break;
+                    }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,112 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_TOOL_CACHE_HPP_INCLUDED
+#define STANDARDESE_TOOL_CACHE_HPP_INCLUDED
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <type_safe/optional.hpp>
+
+#include <cppast/cpp_file.hpp>
+
+#include "filesystem.hpp"
+
+namespace standardese_tool
+{
+struct input_file;
+
+/// A hash of some content, used to detect modifications.
+using content_hash = std::uint64_t;
+
+/// \returns The hash of `size` bytes starting at `data`, combined with `seed`.
+content_hash hash_bytes(const char* data, std::size_t size, content_hash seed) noexcept;
+
+/// \returns The hash of the string, combined with `seed`.
+inline content_hash hash_string(const std::string& str, content_hash seed) noexcept
+{
+    return hash_bytes(str.data(), str.size(), seed);
+}
+
+/// \returns The hash of the contents of the given file, combined with `seed`.
+/// If the file cannot be read, it only hashes the path.
+content_hash hash_file(const fs::path& path, content_hash seed);
+
+/// A persistent cache storing information about the input and output files of a previous run.
+///
+/// Every file is keyed by a hash of its contents, the contents of all files it includes,
+/// directly or indirectly, and the hash of the entire configuration of the run,
+/// so a changed file, header or option invalidates the entry.
+///
+/// It only allows skipping a run as a whole,
+/// the parse results of the individual files are not stored,
+/// so a single modified file still requires parsing and generating all of them again.
+///
+/// The files included by headers are found by scanning them for `#include` directives,
+/// which are looked up relative to the header and in the include directories.
+/// System headers, computed includes and include directories that only appear in the
+/// compilation database are not considered.
+class file_cache
+{
+public:
+    /// \effects Loads the cache stored in the given directory, if there is any.
+    /// The include directories are used to find the files included by headers,
+    /// the parser only reports the files included by an input file itself.
+    /// \notes Entries of a previous run with a different `config_hash` will never match.
+    file_cache(fs::path directory, content_hash config_hash, std::vector<fs::path> include_dirs);
+
+    /// \returns Whether the file is unchanged since the previous run.
+    bool is_unchanged(const fs::path& path) const;
+
+    /// \returns Whether the set of input files is the same as in the previous run,
+    /// none of them has changed,
+    /// and all output files of the previous run still have the content that was written.
+    bool is_unchanged(const std::vector<input_file>& files) const;
+
+    /// \returns The time in seconds it took to parse the file in the previous run,
+    /// if it was recorded.
+    type_safe::optional<double> parse_time(const fs::path& path) const;
+
+    /// \effects Records the result of parsing the file for the next run.
+    /// \notes This function is thread safe.
+    void record(const fs::path& path, const cppast::cpp_file& file, double parse_time);
+
+    /// \effects Records the content of an output file for the next run.
+    /// \notes This function is thread safe.
+    void record_output(const fs::path& path, std::string_view content);
+
+    /// \effects Writes all records of this run to the cache directory,
+    /// replacing the previous ones.
+    void save() const;
+
+private:
+    struct entry
+    {
+        content_hash             hash;
+        double                   parse_time;
+        std::vector<std::string> includes;
+    };
+
+    content_hash get_hash(const std::string& path, const std::vector<std::string>& includes) const;
+
+    std::vector<std::string> get_include_closure(const cppast::cpp_file& file) const;
+
+    fs::path                                      directory_;
+    content_hash                                  config_hash_;
+    std::vector<fs::path>                         include_dirs_;
+    std::unordered_map<std::string, entry>        previous_;
+    std::unordered_map<std::string, content_hash> previous_outputs_;
+
+    mutable std::mutex                            mutex_;
+    std::unordered_map<std::string, entry>        current_;
+    std::unordered_map<std::string, content_hash> current_outputs_;
+};
+} // namespace standardese_tool
+
+#endif // STANDARDESE_TOOL_CACHE_HPP_INCLUDED
@@ -5,11 +5,14 @@
 #ifndef STANDARDESE_FILESYSTEM_HPP_INCLUDED
 #define STANDARDESE_FILESYSTEM_HPP_INCLUDED
 
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include <boost/filesystem.hpp>
 
+#include "thread_pool.hpp"
+
 namespace standardese_tool
 {
 namespace fs = boost::filesystem;
@@ -20,26 +23,14 @@ using whitelist = blacklist;
 
 namespace detail
 {
-    inline fs::path get_relative_path(const fs::path& path, const fs::path& root)
-    {
-#if BOOST_VERSION / 100 % 1000 < 60
-        auto relative = path.c_str() + root.native().size();
-        if (*relative == '/' || *relative == '\\')
-            ++relative;
-        return relative;
-#else
-        return fs::relative(path, root);
-#endif
-    }
-
-    inline bool is_valid(const fs::path& path, const fs::path& relative,
+    inline bool is_valid(const fs::path& path, const fs::path& relative, bool is_directory,
                          const blacklist& extensions, const blacklist& files, const blacklist& dirs,
                          bool blacklist_dotfiles)
     {
         if (blacklist_dotfiles && path.filename().generic_string()[0] == '.')
             return false;
 
-        if (fs::is_directory(path))
+        if (is_directory)
         {
             for (auto& d : dirs)
                 if (relative == d)
@@ -72,12 +63,13 @@ namespace detail
 
 // a path is determined valid through the blacklists
 // if given path is normal file and valid, calls f for it
-// otherwise recursively traverses through the given directory and calls f for each valid file
+// otherwise traverses through the given directory and calls f for each valid file
+// the directories are traversed concurrently, so f must be thread safe
 // returns false if path was a normal file that was marked as invalid, true otherwise
 template <typename Fun>
 bool handle_path(const fs::path& path, const whitelist& source_extensions,
                  const blacklist& extensions, const blacklist& files, blacklist dirs,
-                 bool blacklist_dotfiles, bool force_blacklist, Fun f)
+                 bool blacklist_dotfiles, bool force_blacklist, thread_pool& pool, Fun f)
 {
     // remove trailing slash if any
     // otherwise Boost.Filesystem can't handle it
@@ -89,27 +81,60 @@ bool handle_path(const fs::path& path, const whitelist& source_extensions,
 
     if (fs::is_directory(path))
     {
-        auto end = fs::recursive_directory_iterator();
-        for (auto iter = fs::recursive_directory_iterator(path); iter != end; ++iter)
+        struct directory
+        {
+            fs::path path, relative;
+        };
+
+        // traverse level by level, listing all directories of a level in parallel
+        std::vector<directory> level = {{path, ""}};
+        while (!level.empty())
         {
-            auto& cur      = iter->path();
-            auto  relative = detail::get_relative_path(cur, path);
-
-            if (fs::is_directory(cur))
-            {
-                if (!detail::is_valid(cur, relative, extensions, files, dirs, blacklist_dotfiles))
-                    iter.no_push();
-            }
-            else if (detail::is_valid(cur, relative, extensions, files, dirs, blacklist_dotfiles))
-            {
-                f(detail::is_source_file(cur, source_extensions), cur, relative);
-            }
+            std::mutex             mutex;
+            std::vector<directory> next_level;
+
+            std::vector<std::future<void>> futures;
+            for (auto& dir : level)
+                futures.push_back(add_job(pool, [&] {
+                    std::vector<directory> subdirectories;
+                    for (fs::directory_iterator iter(dir.path), end; iter != end; ++iter)
+                    {
+                        // the type is usually known without a stat,
+                        // only symbolic links need to be resolved
+                        auto type       = iter->symlink_status().type();
+                        auto is_symlink = type == fs::symlink_file;
+                        if (is_symlink)
+                            type = iter->status().type();
+
+                        auto& cur          = iter->path();
+                        auto  relative     = dir.relative / cur.filename();
+                        auto  is_directory = type == fs::directory_file;
+                        if (!detail::is_valid(cur, relative, is_directory, extensions, files, dirs,
+                                              blacklist_dotfiles))
+                            continue;
+                        else if (is_directory)
+                        {
+                            // don't follow symbolic links to directories
+                            if (!is_symlink)
+                                subdirectories.push_back({cur, std::move(relative)});
+                        }
+                        else
+                            f(detail::is_source_file(cur, source_extensions), cur, relative);
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    for (auto& subdirectory : subdirectories)
+                        next_level.push_back(std::move(subdirectory));
+                }));
+            wait_for(futures);
+
+            level = std::move(next_level);
         }
     }
     else if (!fs::exists(path))
         throw std::runtime_error("file '" + path.generic_string() + "' does not exist");
     else if (!force_blacklist
-             || detail::is_valid(path, "", extensions, files, dirs, blacklist_dotfiles))
+             || detail::is_valid(path, "", false, extensions, files, dirs, blacklist_dotfiles))
     {
         // return only the filename of the path as relative path
         f(detail::is_source_file(path, source_extensions), path, path.filename());
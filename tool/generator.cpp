@@ -4,47 +4,113 @@
 
 #include "generator.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <string_view>
 
 #include <standardese/index.hpp>
 #include <standardese/linker.hpp>
+#include <standardese/logger.hpp>
 
 #include "thread_pool.hpp"
 
 using namespace standardese_tool;
 
+namespace
+{
+// estimates the time it takes to parse each file
+// uses the time of the previous run if it is known and the file size otherwise
+std::vector<double> estimate_parse_costs(const std::vector<input_file>&     files,
+                                         type_safe::optional_ref<file_cache> cache)
+{
+    std::vector<double>                      sizes;
+    std::vector<type_safe::optional<double>> times;
+    sizes.reserve(files.size());
+    times.reserve(files.size());
+
+    auto total_size = 0., total_time = 0.;
+    for (auto& file : files)
+    {
+        boost::system::error_code ec;
+        auto                      size = fs::file_size(file.path, ec);
+        sizes.push_back(ec ? 0. : static_cast<double>(size));
+
+        times.push_back(type_safe::nullopt);
+        if (cache)
+            times.back() = cache.value().parse_time(file.path);
+        if (times.back())
+        {
+            total_size += sizes.back();
+            total_time += times.back().value();
+        }
+    }
+
+    // estimate the time of new files using the size
+    auto time_per_byte = total_size > 0. && total_time > 0. ? total_time / total_size : 1.;
+
+    std::vector<double> result;
+    result.reserve(files.size());
+    for (auto i = 0u; i != files.size(); ++i)
+        result.push_back(times[i].value_or(sizes[i] * time_per_byte));
+    return result;
+}
+} // namespace
+
 type_safe::optional<std::vector<parsed_file>> standardese_tool::parse(
     const cppast::libclang_compile_config&                            config,
     const type_safe::optional<cppast::libclang_compilation_database>& database,
     const std::vector<input_file>& files, const cppast::cpp_entity_index& index,
-    unsigned no_threads)
+    const standardese::file_comment_parser& comments, type_safe::optional_ref<file_cache> cache,
+    thread_pool& pool, profiler& prof)
 {
     std::vector<parsed_file> result;
     bool                     error(false);
     cppast::libclang_parser  parser(cppast::default_logger());
 
+    auto costs = estimate_parse_costs(files, cache);
+
+    std::mutex                     mutex;
+    std::vector<std::future<void>> futures;
+    for (auto i = 0u; i != files.size(); ++i)
     {
-        std::mutex  mutex;
-        thread_pool pool(no_threads);
-        for (auto& file : files)
-        {
-            add_job(pool, [&, file] {
-                auto db_config = database.map([&](const cppast::libclang_compilation_database& db) {
-                    return cppast::find_config_for(db, file.path.generic_string());
-                });
+        auto& file = files[i];
+        auto  job  = [&, file] {
+            auto db_config = database.map([&](const cppast::libclang_compilation_database& db) {
+                return cppast::find_config_for(db, file.path.generic_string());
+            });
 
-                auto actual_config = db_config.value_or(config);
-                auto parsed
+            auto actual_config = db_config.value_or(config);
+            auto start         = std::chrono::steady_clock::now();
+
+            std::unique_ptr<cppast::cpp_file> parsed;
+            {
+                auto scope = prof.file("parse", file.relative.generic_string());
+                parsed
                     = parser.parse(index, fs::canonical(file.path).generic_string(), actual_config);
+            }
+            if (parsed && cache)
+            {
+                std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+                cache.value().record(file.path, *parsed, duration.count());
+            }
 
-                std::lock_guard<std::mutex> lock(mutex);
-                if (parsed)
-                    result.push_back({std::move(parsed), file.relative.generic_string()});
-                else
-                    error = true;
-            });
-        }
+            if (parsed)
+            {
+                auto scope = prof.file("parse comments", file.relative.generic_string());
+                comments.parse(type_safe::ref(*parsed));
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (parsed)
+                result.push_back({std::move(parsed), file.relative.generic_string()});
+            else
+                error = true;
+        };
+        futures.push_back(add_job(pool, std::move(job), costs[i]));
     }
+    wait_for(futures);
 
     if (error)
         return type_safe::nullopt;
@@ -52,130 +118,298 @@ type_safe::optional<std::vector<parsed_file>> standardese_tool::parse(
         return std::move(result);
 }
 
-standardese::comment_registry standardese_tool::parse_comments(
-    const standardese::comment::config& config, const std::vector<parsed_file>& files,
-    unsigned no_threads)
-{
-    standardese::file_comment_parser parser(cppast::default_logger(), config);
-    {
-        thread_pool pool(no_threads);
-        for (auto& file : files)
-            add_job(pool, [&file, &parser] { parser.parse(type_safe::ref(*file.file)); });
-    }
-    return parser.finish();
-}
-
 std::vector<std::unique_ptr<standardese::doc_cpp_file>> standardese_tool::build_files(
     const standardese::comment_registry& registry, const cppast::cpp_entity_index& index,
     std::vector<parsed_file>&& files, const standardese::entity_blacklist& blacklist,
-    bool hide_uncommented, unsigned no_threads)
+    bool hide_uncommented, thread_pool& pool, profiler& prof)
 {
-    {
-        thread_pool pool(no_threads);
-        for (auto& file : files)
-            add_job(pool,
-                    [&] { standardese::exclude_entities(registry, index, blacklist, hide_uncommented, *file.file); });
-    }
+    std::vector<std::future<void>> futures;
+
+    // building looks at the excluded entities of other files, so all files need to be processed
+    for (auto& file : files)
+        futures.push_back(add_job(pool, [&] {
+            auto scope = prof.file("exclude", file.output_name);
+            standardese::exclude_entities(registry, index, blacklist, hide_uncommented,
+                                          *file.file);
+        }));
+    wait_for(futures);
 
     std::vector<std::unique_ptr<standardese::doc_cpp_file>> result;
 
-    {
-        std::mutex  mutex;
-        thread_pool pool(no_threads);
-        for (auto& file : files)
-            add_job(pool, [&] {
-                auto entity = standardese::build_doc_entities(type_safe::ref(registry), index,
-                                                              std::move(file.file),
-                                                              std::move(file.output_name));
-
-                std::lock_guard<std::mutex> lock(mutex);
-                result.push_back(std::move(entity));
-            });
-    }
+    std::mutex mutex;
+    for (auto& file : files)
+        futures.push_back(add_job(pool, [&] {
+            auto scope  = prof.file("build", file.output_name);
+            auto entity = standardese::build_doc_entities(type_safe::ref(registry), index,
+                                                          std::move(file.file),
+                                                          std::move(file.output_name));
+
+            std::lock_guard<std::mutex> lock(mutex);
+            result.push_back(std::move(entity));
+        }));
+    wait_for(futures);
 
     return result;
 }
 
 namespace
 {
-std::unique_ptr<standardese::markup::document_entity> get_index_document(
-    std::unique_ptr<standardese::markup::index_entity> index, const char* title, const char* name)
+// the index is generated once the builder exists, so it is allocated in the arena of the document
+template <typename Generator>
+std::unique_ptr<standardese::markup::document_entity> get_index_document(Generator generate,
+                                                                         const char* title,
+                                                                         const char* name)
 {
     standardese::markup::subdocument::builder document(title, name);
-    document.add_child(std::move(index));
+    document.add_child(generate());
     return document.finish();
 }
+
+std::unique_ptr<standardese::markup::document_entity> get_file_document(
+    const standardese::generation_config& gen_config,
+    const standardese::synopsis_config& syn_config, const cppast::cpp_entity_index& index,
+    const standardese::doc_cpp_file& file)
+{
+    standardese::markup::subdocument::builder document(file.output_name(),
+                                                       "doc_"
+                                                           + get_output_file_name(
+                                                                 file.output_name()));
+    document.add_child(standardese::generate_documentation(gen_config, syn_config, index, file));
+    return document.finish();
+}
+
+pending_document keep(std::unique_ptr<standardese::markup::document_entity> doc)
+{
+    auto name = doc->output_name().name();
+    return pending_document{std::move(doc), nullptr, std::move(name)};
+}
 } // namespace
 
 documents standardese_tool::generate(
     const standardese::generation_config& gen_config,
     const standardese::synopsis_config& syn_config, const standardese::comment_registry& comments,
     const cppast::cpp_entity_index& index, const standardese::linker& linker,
-    const std::vector<std::unique_ptr<standardese::doc_cpp_file>>& files, unsigned no_threads)
+    const std::vector<std::unique_ptr<standardese::doc_cpp_file>>& files, bool low_memory,
+    thread_pool& pool, profiler& prof)
 {
-    std::mutex                                                         result_mutex;
-    std::vector<std::unique_ptr<standardese::markup::document_entity>> result;
+    std::mutex result_mutex;
+    documents  result;
 
     standardese::entity_index eindex;
     standardese::file_index   findex;
     standardese::module_index mindex;
 
-    {
-        thread_pool pool(no_threads);
-
-        std::vector<std::future<void>> futures;
-        for (auto& file : files)
-            futures.push_back(add_job(pool, [&] {
-                standardese::markup::subdocument::builder document(file->output_name(),
-                                                                   "doc_"
-                                                                       + get_output_file_name(
-                                                                             file->output_name()));
-                document.add_child(
-                    standardese::generate_documentation(gen_config, syn_config, index, *file));
-                auto finished_doc = document.finish();
-
-                standardese::register_documentations(*cppast::default_logger(), linker,
-                                                     *finished_doc);
-                standardese::register_index_entities(eindex, file->file());
-                standardese::register_module_entities(mindex, comments, file->file());
-                findex.register_file(file->link_name(), file->output_name(),
-                                     file->comment() ? file->comment().value().brief_section()
-                                                     : nullptr);
-
-                std::lock_guard<std::mutex> lock(result_mutex);
-                result.push_back(std::move(finished_doc));
-            }));
-
-        for (auto& future : futures)
-            future.get(); // to retrieve exceptions
-    }
+    std::vector<std::future<void>> futures;
+    for (auto& file : files)
+        futures.push_back(add_job(pool, [&] {
+            auto scope = prof.file("generate", file->output_name());
+
+            auto finished_doc = get_file_document(gen_config, syn_config, index, *file);
+            standardese::register_documentations(*cppast::default_logger(), linker,
+                                                 *finished_doc);
+            standardese::register_index_entities(eindex, file->file());
+            standardese::register_module_entities(mindex, comments, file->file());
+            findex.register_file(file->link_name(), file->output_name(),
+                                 file->comment() ? file->comment().value().brief_section()
+                                                 : nullptr);
+
+            pending_document pending;
+            pending.name = file->output_name();
+            if (low_memory)
+            {
+                // the linker only stores names and the indices borrow the briefs of the comment
+                // registry, so the document can be generated again once it is needed
+                finished_doc.reset();
+                pending.regenerate = [&] {
+                    auto scope = prof.file("generate", file->output_name());
+                    return get_file_document(gen_config, syn_config, index, *file);
+                };
+            }
+            else
+                pending.document = std::move(finished_doc);
 
-    auto eindex_doc = get_index_document(eindex.generate(gen_config.order()), "Entities",
-                                         "standardese_entities");
+            std::lock_guard<std::mutex> lock(result_mutex);
+            result.push_back(std::move(pending));
+        }));
+
+    wait_for(futures);
+
+    auto eindex_doc = get_index_document([&] { return eindex.generate(gen_config.order()); },
+                                         "Entities", "standardese_entities");
     standardese::register_documentations(*cppast::default_logger(), linker, *eindex_doc);
-    result.push_back(std::move(eindex_doc));
+    result.push_back(keep(std::move(eindex_doc)));
 
-    auto findex_doc = get_index_document(findex.generate(), "Files", "standardese_files");
+    auto findex_doc
+        = get_index_document([&] { return findex.generate(); }, "Files", "standardese_files");
     standardese::register_documentations(*cppast::default_logger(), linker, *findex_doc);
-    result.push_back(std::move(findex_doc));
+    result.push_back(keep(std::move(findex_doc)));
 
-    auto mindex_doc = get_index_document(mindex.generate(), "Modules", "standardese_modules");
+    auto mindex_doc = get_index_document([&] { return mindex.generate(); }, "Modules",
+                                         "standardese_modules");
     standardese::register_documentations(*cppast::default_logger(), linker, *mindex_doc);
-    result.push_back(std::move(mindex_doc));
+    result.push_back(keep(std::move(mindex_doc)));
+
+    return result;
+}
+
+namespace
+{
+bool has_content(const std::string& path, std::string_view content)
+{
+    boost::system::error_code ec;
+    if (fs::file_size(path, ec) != content.size() || ec)
+        return false;
+
+    std::ifstream file(path, std::ios_base::binary);
+    std::string   existing(content.size(), '\0');
+    return file.read(&existing[0], std::streamsize(existing.size())) && existing == content;
+}
+
+// returns false if the content couldn't be written entirely, e.g. if the disk is full
+bool write_file(const std::string& path, std::string_view content)
+{
+    std::ofstream file(path, std::ios_base::binary);
+    file.write(content.data(), std::streamsize(content.size()));
+    file.close();
+    return !file.fail();
+}
+
+template <typename... Args>
+void log_file_warning(const std::string& path, Args&&... args)
+{
+    auto location = cppast::source_location::make_file(path);
+    cppast::default_logger()->log("standardese",
+                                  standardese::make_diagnostic(std::move(location),
+                                                               std::forward<Args>(args)...));
+}
+
+std::string get_manifest_path(const std::string& prefix)
+{
+    return prefix + ".standardese_manifest";
+}
+
+std::vector<std::string> read_manifest(const std::string& prefix)
+{
+    std::vector<std::string> result;
 
-    for (auto& doc : result)
-        standardese::resolve_links(*cppast::default_logger(), linker, *doc);
+    std::ifstream manifest(get_manifest_path(prefix));
+    std::string   line;
+    while (std::getline(manifest, line))
+        if (!line.empty())
+            result.push_back(std::move(line));
 
     return result;
 }
 
-void standardese_tool::write_files(const documents& docs, standardese::markup::generator generator,
-                                   std::string prefix, const char* extension, unsigned no_threads)
+// whether the manifest entry refers to a file below the prefix,
+// the manifest might have been edited
+bool is_safe_manifest_entry(const std::string& file)
 {
-    thread_pool pool(no_threads);
-    for (auto& doc : docs)
-        add_job(pool, [&] {
-            std::ofstream file(prefix + doc->output_name().file_name(extension));
-            generator(file, *doc);
-        });
+    fs::path path(file);
+    if (path.has_root_path())
+        return false;
+    for (auto& component : path)
+        if (component == "..")
+            return false;
+    return true;
+}
+
+void write_manifest(const std::string& prefix, const std::vector<std::string>& files)
+{
+    std::string content;
+    for (auto& file : files)
+        content += file + '\n';
+
+    // like the documents, it is only written if it changed
+    auto path = get_manifest_path(prefix);
+    if (!has_content(path, content) && !write_file(path, content))
+        log_file_warning(path, "unable to write manifest");
+}
+} // namespace
+
+std::vector<write_statistics> standardese_tool::write_files(
+    documents&& docs, const standardese::linker& linker, const std::vector<output_format>& formats,
+    bool remove_stale, type_safe::optional_ref<file_cache> cache, thread_pool& pool,
+    profiler& prof)
+{
+    // counted per format
+    std::vector<std::atomic<unsigned>> written(formats.size()), unchanged(formats.size()),
+        failed(formats.size());
+
+    // the file names of every document in every format, for the manifest
+    std::vector<std::vector<std::string>> file_names(formats.size(),
+                                                     std::vector<std::string>(docs.size()));
+
+    // all documentations are registered now, so links can be resolved in parallel
+    // one job per document renders all formats, so its tree is only fetched once
+    std::vector<std::future<void>> futures;
+    for (auto i = 0u; i != docs.size(); ++i)
+        futures.push_back(add_job(pool, [&, i] {
+            auto name = std::move(docs[i].name);
+            auto doc  = docs[i].get();
+            docs[i]   = pending_document{};
+
+            auto scope = prof.file("write", std::move(name));
+            standardese::resolve_links(*cppast::default_logger(), linker, *doc);
+
+            // the buffer is reused for every format, so it only grows once
+            standardese::markup::output_buffer buffer(64u * 1024u);
+            for (auto f = 0u; f != formats.size(); ++f)
+            {
+                auto& format = formats[f];
+
+                buffer.clear();
+                format.generator(buffer, *doc);
+                auto content = buffer.view();
+
+                // don't touch unchanged files, so their modification time stays the same
+                file_names[f][i] = doc->output_name().file_name(format.extension);
+                auto path        = format.prefix + file_names[f][i];
+                // recorded even if writing fails, so the next run isn't skipped
+                if (cache)
+                    cache.value().record_output(path, content);
+                if (has_content(path, content))
+                    ++unchanged[f];
+                else if (write_file(path, content))
+                    ++written[f];
+                else
+                {
+                    log_file_warning(path, "unable to write documentation file");
+                    ++failed[f];
+                }
+            }
+        }));
+    wait_for(futures);
+
+    std::vector<write_statistics> result;
+    for (auto f = 0u; f != formats.size(); ++f)
+    {
+        auto& format = formats[f];
+        result.push_back({written[f], unchanged[f], 0u, failed[f]});
+
+        // the files are stored relative to the prefix
+        auto& files = file_names[f];
+        std::sort(files.begin(), files.end());
+
+        if (remove_stale)
+        {
+            for (auto& file : read_manifest(format.prefix))
+            {
+                if (!is_safe_manifest_entry(file)
+                    || std::binary_search(files.begin(), files.end(), file))
+                    continue;
+
+                // a file that can't be removed must not abort the run
+                boost::system::error_code ec;
+                if (fs::remove(format.prefix + file, ec))
+                    ++result.back().deleted;
+                else if (ec)
+                    log_file_warning(format.prefix + file,
+                                     "unable to remove stale file: ", ec.message());
+            }
+            write_manifest(format.prefix, files);
+        }
+    }
+
+    return result;
 }
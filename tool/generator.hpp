@@ -5,8 +5,11 @@
 #ifndef STANDARDESE_TOOL_GENERATOR_HPP_INCLUDED
 #define STANDARDESE_TOOL_GENERATOR_HPP_INCLUDED
 
+#include <functional>
 #include <vector>
 
+#include <type_safe/optional_ref.hpp>
+
 #include <cppast/cpp_entity_index.hpp>
 #include <cppast/cpp_file.hpp>
 #include <cppast/libclang_parser.hpp>
@@ -17,7 +20,10 @@
 #include <standardese/markup/document.hpp>
 #include <standardese/markup/generator.hpp>
 
+#include "cache.hpp"
 #include "filesystem.hpp"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
 
 namespace standardese_tool
 {
@@ -33,32 +39,73 @@ struct parsed_file
     std::string                       output_name;
 };
 
+// parses all files and the documentation comments in them
+// the comments of a file are parsed by the same job as soon as the file itself is parsed
 type_safe::optional<std::vector<parsed_file>> parse(
     const cppast::libclang_compile_config&                            config,
     const type_safe::optional<cppast::libclang_compilation_database>& database,
     const std::vector<input_file>& files, const cppast::cpp_entity_index& index,
-    unsigned no_threads);
-
-standardese::comment_registry parse_comments(const standardese::comment::config& config,
-                                             const std::vector<parsed_file>&     files,
-                                             unsigned                            no_threads);
+    const standardese::file_comment_parser& comments, type_safe::optional_ref<file_cache> cache,
+    thread_pool& pool, profiler& prof);
 
 std::vector<std::unique_ptr<standardese::doc_cpp_file>> build_files(
     const standardese::comment_registry& registry, const cppast::cpp_entity_index& index,
     std::vector<parsed_file>&& files, const standardese::entity_blacklist& blacklist,
-    bool hide_uncommented, unsigned no_threads);
+    bool hide_uncommented, thread_pool& pool, profiler& prof);
+
+// a document that is either kept in memory or generated again when it is needed
+struct pending_document
+{
+    std::unique_ptr<standardese::markup::document_entity>                   document;
+    std::function<std::unique_ptr<standardese::markup::document_entity>()> regenerate;
+    // the name of the document in the profile, same as in the other phases
+    std::string name;
+
+    // returns the document, it can only be retrieved once
+    std::unique_ptr<standardese::markup::document_entity> get()
+    {
+        return document ? std::move(document) : regenerate();
+    }
+};
 
-using documents = std::vector<std::unique_ptr<standardese::markup::document_entity>>;
+using documents = std::vector<pending_document>;
 
+// generates the documents of all files and the indices and registers them in the linker
+// if low_memory is set, the documents of the files are dropped once their link names and index
+// entries have been registered and generated again when they are written,
+// so only the indices and the documents currently written are kept in memory
 documents generate(const standardese::generation_config& gen_config,
                    const standardese::synopsis_config&   syn_config,
                    const standardese::comment_registry&  comments,
                    const cppast::cpp_entity_index& index, const standardese::linker& linker,
                    const std::vector<std::unique_ptr<standardese::doc_cpp_file>>& files,
-                   unsigned                                                       no_threads);
+                   bool low_memory, thread_pool& pool, profiler& prof);
+
+struct write_statistics
+{
+    unsigned written, unchanged, deleted;
+    unsigned failed; // couldn't be written, a warning has been logged
+};
+
+struct output_format
+{
+    standardese::markup::generator generator;
+    std::string                    prefix;
+    const char*                    extension;
+};
 
-void write_files(const documents& docs, standardese::markup::generator generator,
-                 std::string prefix, const char* extension, unsigned no_threads);
+// resolves the links of the documents and writes them in all formats,
+// skipping files whose content would not change
+// each document is destroyed as soon as it is written
+// if remove_stale is set, the written files are recorded in a manifest next to them,
+// so files written by a previous run that are no longer generated can be removed
+// the content of every file is recorded in the cache, if there is one
+// returns the statistics of every format
+std::vector<write_statistics> write_files(documents&& docs, const standardese::linker& linker,
+                                          const std::vector<output_format>&   formats,
+                                          bool                                remove_stale,
+                                          type_safe::optional_ref<file_cache> cache,
+                                          thread_pool& pool, profiler& prof);
 } // namespace standardese_tool
 
 #endif // STANDARDESE_TOOL_GENERATOR_HPP_INCLUDED
@@ -3,14 +3,20 @@
 // This file is subject to the license terms in the LICENSE file
 // found in the top-level directory of this distribution.
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 
 #include <boost/program_options.hpp>
 
+#include "cache.hpp"
 #include "filesystem.hpp"
 #include "generator.hpp"
 #include "thread_pool.hpp"
+#include "watcher.hpp"
 
 namespace po = boost::program_options;
 namespace fs = boost::filesystem;
@@ -126,6 +132,7 @@ cppast::libclang_compile_config get_compile_config(const po::variables_map& opti
     cppast::libclang_compile_config config;
 
     config.remove_comments_in_macro(!get_option<bool>(options, "compilation.keep_comments_in_macro").value());
+    config.fast_preprocessing(get_option<bool>(options, "compilation.fast_preprocessing").value());
 
     cppast::compile_flags flags;
     if (auto gnu_ext = get_option<bool>(options, "compilation.gnu_extensions"))
@@ -173,7 +180,59 @@ type_safe::optional<cppast::libclang_compilation_database> get_compilation_datab
         return type_safe::nullopt;
 }
 
-std::vector<standardese_tool::input_file> get_input(const po::variables_map& options)
+// returns the number of arguments starting at argv[i] that form an option which doesn't influence
+// the generated documentation, or 0 if it is any other argument
+int get_non_semantic_option(int i, int argc, char* argv[])
+{
+    std::string arg(argv[i]);
+    auto        is_option = [&](const char* name) {
+        return arg == name || arg.compare(0, std::strlen(name) + 1u, std::string(name) + '=') == 0;
+    };
+
+    if (is_option("--watch") || is_option("--verbose") || arg == "-w" || arg == "-v")
+        return 1;
+    else if (arg == "--profile" || arg == "--jobs" || arg == "-j")
+        // the value is the next argument
+        return i + 1 < argc ? 2 : 1;
+    else if (is_option("--profile") || is_option("--jobs") || arg.compare(0, 2u, "-j") == 0)
+        return 1;
+    else
+        return 0;
+}
+
+std::unique_ptr<standardese_tool::file_cache> get_cache(int argc, char* argv[],
+                                                       const po::variables_map& options)
+{
+    auto dir = get_option<std::string>(options, "compilation.cache_dir");
+    if (!dir)
+        return nullptr;
+
+    // hash everything that can influence the output
+    auto hash = standardese_tool::hash_string(std::to_string(STANDARDESE_VERSION_MAJOR) + '.'
+                                                  + std::to_string(STANDARDESE_VERSION_MINOR),
+                                              0u);
+    for (auto i = 1; i < argc;)
+        if (auto skip = get_non_semantic_option(i, argc, argv))
+            // e.g. profiling a run shouldn't regenerate everything
+            i += skip;
+        else
+            hash = standardese_tool::hash_string(argv[i++], hash);
+    if (auto config = get_option<fs::path>(options, "config"))
+        hash = standardese_tool::hash_file(config.value(), hash);
+    if (auto commands_dir = get_option<std::string>(options, "compilation.commands_dir"))
+        hash = standardese_tool::hash_file(fs::path(commands_dir.value()) / "compile_commands.json",
+                                           hash);
+
+    std::vector<fs::path> include_dirs;
+    if (auto includes = get_option<std::vector<std::string>>(options, "compilation.include_dir"))
+        include_dirs.assign(includes.value().begin(), includes.value().end());
+
+    return std::unique_ptr<standardese_tool::file_cache>(
+        new standardese_tool::file_cache(dir.value(), hash, std::move(include_dirs)));
+}
+
+std::vector<standardese_tool::input_file> get_input(const po::variables_map&      options,
+                                                    standardese_tool::thread_pool& pool)
 {
     auto source_ext = get_option<std::vector<std::string>>(options, "input.source_ext").value();
     auto blacklist_ext
@@ -189,14 +248,27 @@ std::vector<standardese_tool::input_file> get_input(const po::variables_map& opt
     if (!input_files)
         throw std::invalid_argument("no input files specified");
 
+    std::mutex                                mutex;
     std::vector<standardese_tool::input_file> files;
     for (auto& file : input_files.value())
         standardese_tool::handle_path(file, source_ext, blacklist_ext, blacklist_files,
-                                      blacklist_dirs, blacklist_dotfiles, force_blacklist,
-                                      [&](bool, const fs::path& path, const fs::path& relative) {
+                                      blacklist_dirs, blacklist_dotfiles, force_blacklist, pool,
+                                      [&](bool is_source, const fs::path& path,
+                                          const fs::path& relative) {
+                                          // only parse source files,
+                                          // unless they were explicitly given
+                                          if (!is_source && path != file)
+                                              return;
+
+                                          std::lock_guard<std::mutex> lock(mutex);
                                           files.push_back({path, relative});
                                       });
 
+    // traversal order is not deterministic
+    std::sort(files.begin(), files.end(),
+              [](const standardese_tool::input_file& a, const standardese_tool::input_file& b) {
+                  return a.path < b.path;
+              });
     return files;
 }
 
@@ -316,6 +388,142 @@ void register_external_documentations(standardese::linker& l, const po::variable
     }
 }
 
+// generates the documentation once
+// returns the exit code
+int run(int argc, char* argv[], const po::variables_map& options,
+        standardese_tool::thread_pool& pool)
+{
+    auto compile_config = get_compile_config(options);
+    auto database       = get_compilation_database(options);
+    auto input          = get_input(options, pool);
+    auto cache          = get_cache(argc, argv, options);
+
+    auto comment_config    = get_comment_config(options);
+    auto synopsis_config   = get_synopsis_config(options);
+    auto generation_config = get_generation_config(options);
+
+    auto blacklist = get_blacklist(options);
+
+    auto formats      = get_formats(options);
+    auto prefix       = get_option<std::string>(options, "output.prefix").value();
+    auto remove_stale = get_option<bool>(options, "output.remove_stale").value();
+    auto verbose      = get_option<bool>(options, "verbose").value();
+    auto low_memory   = get_option<bool>(options, "output.low_memory").value();
+
+    standardese::linker linker;
+    register_external_documentations(linker, options);
+
+    try
+    {
+        if (cache && cache->is_unchanged(input))
+        {
+            std::clog << "documentation is up to date\n";
+            return 0;
+        }
+
+        auto                       profile = get_option<fs::path>(options, "profile");
+        standardese_tool::profiler prof(profile.has_value());
+
+        cppast::cpp_entity_index         index;
+        standardese::file_comment_parser comment_parser(cppast::default_logger(), comment_config,
+                                                        type_safe::ref(blacklist));
+
+        std::clog << "parsing C++ files and documentation comments...\n";
+        auto parsed = [&] {
+            auto scope = prof.phase("parse");
+            return standardese_tool::parse(compile_config, database, input, index, comment_parser,
+                                           type_safe::opt_ref(cache.get()), pool, prof);
+        }();
+        if (!parsed)
+            return 1;
+
+        auto comments = [&] {
+            auto scope = prof.phase("finish comments");
+            return comment_parser.finish(type_safe::ref(pool));
+        }();
+        if (verbose)
+        {
+            auto statistics = comment_parser.statistics();
+            std::clog << "reused the result of " << statistics.reused << " of "
+                      << statistics.comments << " comments";
+            if (statistics.comments > 0u)
+                std::clog << " (" << 100 * statistics.reused / statistics.comments << "%)";
+            std::clog << '\n';
+        }
+        auto files = [&] {
+            auto scope = prof.phase("build");
+            return standardese_tool::build_files(
+                comments, index, std::move(parsed.value()), blacklist,
+                generation_config.is_flag_set(standardese::generation_config::hide_uncommented),
+                pool, prof);
+        }();
+
+        std::clog << "generating documentation...\n";
+        auto docs = [&] {
+            auto scope = prof.phase("generate");
+            return standardese_tool::generate(generation_config, synopsis_config, comments, index,
+                                              linker, files, low_memory, pool, prof);
+        }();
+
+        std::clog << "writing files...\n";
+        std::vector<standardese_tool::output_format> outputs;
+        for (auto& format : formats)
+        {
+            auto format_prefix
+                = formats.size() > 1u ? std::string(format.second) + '/' + prefix : prefix;
+            if (!format_prefix.empty())
+                fs::create_directories(fs::path(format_prefix).parent_path());
+            outputs.push_back({std::move(format.first), std::move(format_prefix), format.second});
+        }
+
+        {
+            auto scope      = prof.phase("write");
+            auto statistics = standardese_tool::write_files(std::move(docs), linker, outputs,
+                                                            remove_stale,
+                                                            type_safe::opt_ref(cache.get()), pool,
+                                                            prof);
+            for (auto i = 0u; i != outputs.size(); ++i)
+                std::clog << "format '" << outputs[i].extension << "': " << statistics[i].written
+                          << " written, " << statistics[i].unchanged << " unchanged, "
+                          << statistics[i].deleted << " deleted, " << statistics[i].failed
+                          << " failed\n";
+        }
+
+        if (profile)
+        {
+            prof.write_trace(profile.value());
+            prof.print_summary(std::cerr, 10u);
+        }
+
+        if (cache)
+            cache->save();
+    }
+    catch (std::exception& ex)
+    {
+        std::cerr << "error: " << ex.what() << '\n';
+    }
+
+    return 0;
+}
+
+// whether any of the modified files is an input file that needs to be parsed again
+bool needs_regeneration(const po::variables_map&              options,
+                        const standardese_tool::modifications& modified)
+{
+    if (modified.unknown)
+        return true;
+
+    auto source_ext = get_option<std::vector<std::string>>(options, "input.source_ext").value();
+    auto inputs     = get_option<std::vector<fs::path>>(options, "input-files").value();
+    return std::any_of(modified.files.begin(), modified.files.end(), [&](const fs::path& path) {
+        // files given explicitly are parsed regardless of their extension
+        return standardese_tool::detail::is_source_file(path, source_ext)
+               || std::any_of(inputs.begin(), inputs.end(), [&](const fs::path& input) {
+                      return fs::absolute(input) == path;
+                  });
+    });
+}
+
 int main(int argc, char* argv[])
 {
     // clang-format off
@@ -327,7 +535,11 @@ int main(int argc, char* argv[])
         ("verbose,v", po::value<bool>()->implicit_value(true)->default_value(false),
          "prints more information")
         ("jobs,j", po::value<unsigned>()->default_value(standardese_tool::default_no_threads()),
-         "sets the number of threads to use");
+         "sets the number of threads to use")
+        ("profile", po::value<fs::path>(),
+         "writes the time spent on every phase and file as Chrome trace to the given file and prints the slowest files")
+        ("watch,w", po::value<bool>()->implicit_value(true)->default_value(false),
+         "keeps running and reruns the whole generation whenever an input file is modified, nothing is kept between the runs");
 
     configuration.add_options()
         ("input.source_ext",
@@ -386,6 +598,11 @@ int main(int argc, char* argv[])
         ("compilation.keep_comments_in_macro",
          po::value<bool>()->implicit_value(true)->default_value(false),
          "disable/enable removal of comments during macro evaluation (-CC)")
+        ("compilation.fast_preprocessing",
+         po::value<bool>()->implicit_value(true)->default_value(false),
+         "opt-in: enable/disable fast preprocessing, which only preprocesses the parsed header and not the files it includes; macros defined in included files are not expanded then, so the output is only the same if the headers don't use such macros")
+        ("compilation.cache_dir", po::value<std::string>(),
+         "the directory where information about the parsed and written files is cached, nothing is regenerated if no input, included file, option or output file changed since the previous run, otherwise everything is; headers are only found in the directory of the including file and the include directories, system headers, computed includes and the flags of the compilation database are not considered")
 
         ("comment.command_character", po::value<char>()->default_value(standardese::comment::config::options().command_character),
          "character used to introduce special commands")
@@ -401,6 +618,12 @@ int main(int argc, char* argv[])
         ("output.prefix",
          po::value<std::string>()->default_value(""),
          "a prefix that will be added to all output files")
+        ("output.remove_stale",
+         po::value<bool>()->implicit_value(true)->default_value(false),
+         "whether or not output files written by a previous run that are no longer generated are removed, the files written are listed in a .standardese_manifest file next to them")
+        ("output.low_memory",
+         po::value<bool>()->implicit_value(true)->default_value(false),
+         "whether or not the documentation of each file is generated again while writing instead of keeping all of it in memory, the parsed files, the entity index and the comments are kept in memory either way")
         ("output.format",
          po::value<std::vector<std::string>>()->default_value(std::vector<std::string>{"commonmark"}, "{commonmark}"),
          "the output format used (html, commonmark, commonmark_html, xml, text)")
@@ -433,60 +656,29 @@ int main(int argc, char* argv[])
             print_usage(argv[0], generic, configuration);
         else
         {
-            auto no_threads = get_option<unsigned>(options, "jobs").value();
-
-            auto compile_config = get_compile_config(options);
-            auto database       = get_compilation_database(options);
-            auto input          = get_input(options);
-
-            auto comment_config    = get_comment_config(options);
-            auto synopsis_config   = get_synopsis_config(options);
-            auto generation_config = get_generation_config(options);
+            standardese_tool::thread_pool pool(get_option<unsigned>(options, "jobs").value());
 
-            auto blacklist = get_blacklist(options);
+            auto result = run(argc, argv, options, pool);
+            if (!get_option<bool>(options, "watch").value())
+                return result;
 
-            auto formats = get_formats(options);
-            auto prefix  = get_option<std::string>(options, "output.prefix").value();
-
-            standardese::linker linker;
-            register_external_documentations(linker, options);
-
-            try
+            // keep everything running and regenerate on changes
+            standardese_tool::file_watcher watcher(
+                get_option<std::vector<fs::path>>(options, "input-files").value());
+            while (true)
             {
-                cppast::cpp_entity_index index;
-
-                std::clog << "parsing C++ files...\n";
-                auto parsed
-                    = standardese_tool::parse(compile_config, database, input, index, no_threads);
-                if (!parsed)
-                    return 1;
-
-                std::clog << "parsing documentation comments...\n";
-                auto comments
-                    = standardese_tool::parse_comments(comment_config, parsed.value(), no_threads);
-                auto files
-                    = standardese_tool::build_files(comments, index, std::move(parsed.value()),
-                                                    blacklist, generation_config.is_flag_set(standardese::generation_config::hide_uncommented), no_threads);
-
-                std::clog << "generating documentation...\n";
-                auto docs = standardese_tool::generate(generation_config, synopsis_config, comments,
-                                                       index, linker, files, no_threads);
-
-                for (auto& format : formats)
+                std::clog << "watching for modifications...\n";
+                if (!needs_regeneration(options, watcher.wait()))
+                    continue;
+
+                try
                 {
-                    std::clog << "writing files in format '" << format.second << "'...\n";
-
-                    auto format_prefix
-                        = formats.size() > 1u ? std::string(format.second) + '/' + prefix : prefix;
-                    if (!format_prefix.empty())
-                        fs::create_directories(fs::path(format_prefix).parent_path());
-                    standardese_tool::write_files(docs, format.first, std::move(format_prefix),
-                                                  format.second, no_threads);
+                    run(argc, argv, options, pool);
+                }
+                catch (std::exception& ex)
+                {
+                    std::cerr << "error: " << ex.what() << '\n';
                 }
-            }
-            catch (std::exception& ex)
-            {
-                std::cerr << "error: " << ex.what() << '\n';
             }
         }
     }
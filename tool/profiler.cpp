@@ -0,0 +1,178 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#endif
+
+using namespace standardese_tool;
+
+namespace
+{
+double get_cpu_time(bool process)
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID) && defined(CLOCK_PROCESS_CPUTIME_ID)
+    timespec time;
+    if (clock_gettime(process ? CLOCK_PROCESS_CPUTIME_ID : CLOCK_THREAD_CPUTIME_ID, &time) == 0)
+        return double(time.tv_sec) + double(time.tv_nsec) / 1e9;
+#endif
+    // fallback, always uses the time of the process
+    (void)process;
+    return double(std::clock()) / CLOCKS_PER_SEC;
+}
+
+double to_seconds(profiler::clock::duration d)
+{
+    return std::chrono::duration<double>(d).count();
+}
+
+void write_json_string(std::ostream& out, const std::string& str)
+{
+    out << '"';
+    for (auto c : str)
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec
+                << std::setfill(' ');
+        else
+            out << c;
+    out << '"';
+}
+} // namespace
+
+profiler::scope::scope(profiler* p, const char* phase, std::string file, bool process_cpu)
+: profiler_(p), phase_(phase), file_(std::move(file)), start_(clock::now()),
+  start_cpu_(p ? get_cpu_time(process_cpu) : 0.), process_cpu_(process_cpu)
+{}
+
+profiler::scope::scope(scope&& other) noexcept
+: profiler_(other.profiler_), phase_(other.phase_), file_(std::move(other.file_)),
+  start_(other.start_), start_cpu_(other.start_cpu_), process_cpu_(other.process_cpu_)
+{
+    other.profiler_ = nullptr;
+}
+
+profiler::scope::~scope() noexcept
+{
+    if (!profiler_)
+        return;
+
+    auto end = clock::now();
+    try
+    {
+        profiler_->record(event{phase_, std::move(file_), to_seconds(start_ - profiler_->start_),
+                                to_seconds(end - start_),
+                                get_cpu_time(process_cpu_) - start_cpu_, 0u});
+    }
+    catch (...)
+    {
+        // profiling must not abort the run
+    }
+}
+
+void profiler::record(event e)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto thread = threads_.emplace(std::this_thread::get_id(), unsigned(threads_.size())).first;
+    e.thread    = thread->second;
+    events_.push_back(std::move(e));
+}
+
+void profiler::write_trace(const fs::path& path) const
+{
+    std::ofstream out(path.string());
+    if (!out)
+        throw std::runtime_error("unable to write profile to '" + path.generic_string() + "'");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    out << "{\"traceEvents\":[";
+    auto first = true;
+    for (auto& e : events_)
+    {
+        if (!first)
+            out << ',';
+        first = false;
+
+        out << "\n{\"name\":";
+        write_json_string(out, e.file.empty() ? e.phase : e.file);
+        out << ",\"cat\":";
+        write_json_string(out, e.file.empty() ? "phase" : e.phase);
+        out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread;
+        out << std::fixed << std::setprecision(3);
+        out << ",\"ts\":" << e.start * 1e6 << ",\"dur\":" << e.wall * 1e6;
+        out << ",\"args\":{\"cpu_ms\":" << e.cpu * 1e3 << "}}";
+        out << std::defaultfloat;
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void profiler::print_summary(std::ostream& out, std::size_t no_files) const
+{
+    struct file_time
+    {
+        std::string                   name;
+        double                        wall = 0.;
+        std::map<std::string, double> phases;
+    };
+
+    std::vector<file_time> files;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::unordered_map<std::string, std::size_t> indices;
+        for (auto& e : events_)
+        {
+            if (e.file.empty())
+            {
+                out << "phase '" << e.phase << "': " << std::fixed << std::setprecision(3)
+                    << e.wall << "s wall, " << e.cpu << "s CPU\n"
+                    << std::defaultfloat;
+                continue;
+            }
+
+            auto iter = indices.emplace(e.file, files.size()).first;
+            if (iter->second == files.size())
+                files.push_back(file_time{e.file, 0., {}});
+
+            auto& file = files[iter->second];
+            file.wall += e.wall;
+            file.phases[e.phase] += e.wall;
+        }
+    }
+
+    no_files = std::min(no_files, files.size());
+    std::partial_sort(files.begin(), files.begin() + std::ptrdiff_t(no_files), files.end(),
+                      [](const file_time& a, const file_time& b) { return a.wall > b.wall; });
+
+    out << "slowest files:\n";
+    for (auto i = 0u; i != no_files; ++i)
+    {
+        auto& file = files[i];
+        out << std::fixed << std::setprecision(3) << std::setw(9) << file.wall << "s  "
+            << file.name << " (";
+
+        auto first = true;
+        for (auto& phase : file.phases)
+        {
+            if (!first)
+                out << ", ";
+            first = false;
+            out << phase.first << ' ' << phase.second << 's';
+        }
+        out << ")\n" << std::defaultfloat;
+    }
+}
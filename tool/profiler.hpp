@@ -0,0 +1,98 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_TOOL_PROFILER_HPP_INCLUDED
+#define STANDARDESE_TOOL_PROFILER_HPP_INCLUDED
+
+#include <chrono>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "filesystem.hpp"
+
+namespace standardese_tool
+{
+// records the wall and CPU time of the phases of a run and of every file in each phase
+// a disabled profiler does not record anything
+class profiler
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    // measures the time until it is destroyed
+    class scope
+    {
+    public:
+        scope(scope&& other) noexcept;
+        ~scope() noexcept;
+
+        scope& operator=(scope&&) = delete;
+
+    private:
+        scope(profiler* p, const char* phase, std::string file, bool process_cpu);
+
+        profiler*         profiler_;
+        const char*       phase_;
+        std::string       file_;
+        clock::time_point start_;
+        double            start_cpu_;
+        bool              process_cpu_;
+
+        friend profiler;
+    };
+
+    explicit profiler(bool enabled) : start_(clock::now()), enabled_(enabled) {}
+
+    bool is_enabled() const noexcept
+    {
+        return enabled_;
+    }
+
+    // measures an entire phase, must be used by the thread waiting for the phase
+    // its CPU time is the time of the entire process
+    scope phase(const char* name)
+    {
+        return scope(enabled_ ? this : nullptr, name, "", true);
+    }
+
+    // measures the work for one file in a phase, must be used by the thread doing the work
+    // its CPU time is the time of that thread
+    // \notes This function is thread safe.
+    scope file(const char* phase, std::string name)
+    {
+        return scope(enabled_ ? this : nullptr, phase, enabled_ ? std::move(name) : "", false);
+    }
+
+    // writes all recorded events in the Chrome trace event format,
+    // see chrome://tracing or https://ui.perfetto.dev
+    void write_trace(const fs::path& path) const;
+
+    // prints the files that took the longest time over all phases
+    void print_summary(std::ostream& out, std::size_t no_files) const;
+
+private:
+    struct event
+    {
+        const char* phase;
+        std::string file;
+        double      start, wall, cpu; // in seconds
+        unsigned    thread;
+    };
+
+    void record(event e);
+
+    clock::time_point start_;
+
+    mutable std::mutex                            mutex_;
+    std::vector<event>                            events_;
+    std::unordered_map<std::thread::id, unsigned> threads_;
+    bool                                          enabled_;
+};
+} // namespace standardese_tool
+
+#endif // STANDARDESE_TOOL_PROFILER_HPP_INCLUDED
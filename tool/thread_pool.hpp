@@ -2,30 +2,56 @@
 // This file is subject to the license terms in the LICENSE file
 // found in the top-level directory of this distribution.
 
-#ifndef STANDARDESE_THREAD_POOL_HPP_INCLUDED
-#define STANDARDESE_THREAD_POOL_HPP_INCLUDED
+#ifndef STANDARDESE_TOOL_THREAD_POOL_HPP_INCLUDED
+#define STANDARDESE_TOOL_THREAD_POOL_HPP_INCLUDED
 
+#include <exception>
 #include <future>
-#include <thread>
+#include <type_traits>
 #include <vector>
 
-#include <ThreadPool.h>
+#include <standardese/thread_pool.hpp>
 
 namespace standardese_tool
 {
-using thread_pool = ::ThreadPool;
+using thread_pool = standardese::thread_pool;
 
 inline unsigned default_no_threads()
 {
-    return std::max(std::thread::hardware_concurrency(), 1u);
+    return thread_pool::default_no_threads();
 }
 
-template <typename Fnc, typename... Args>
-auto add_job(thread_pool& p, Fnc f, Args&&... args)
-    -> std::future<typename std::result_of<Fnc(Args...)>::type>
+// jobs with a higher estimated cost are started first
+template <typename Fnc>
+auto add_job(thread_pool& p, Fnc f, double cost = 0.)
+    -> std::future<std::invoke_result_t<Fnc>>
 {
-    return p.enqueue(f, std::forward<Args>(args)...);
+    return p.add_job(std::move(f), cost);
+}
+
+// waits until all jobs are finished
+// rethrows the first exception a job has thrown, if any
+// requires: not called from a worker of the pool,
+// a worker blocking on nested jobs doesn't run them and can deadlock the pool
+template <typename T>
+void wait_for(std::vector<std::future<T>>& futures)
+{
+    std::exception_ptr exception;
+    for (auto& future : futures)
+        try
+        {
+            future.get();
+        }
+        catch (...)
+        {
+            if (!exception)
+                exception = std::current_exception();
+        }
+    futures.clear();
+
+    if (exception)
+        std::rethrow_exception(exception);
 }
 } // namespace standardese_tool
 
-#endif // STANDARDESE_THREAD_POOL_HPP_INCLUDED
+#endif // STANDARDESE_TOOL_THREAD_POOL_HPP_INCLUDED
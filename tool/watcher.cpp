@@ -0,0 +1,251 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include "watcher.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace standardese_tool;
+
+namespace
+{
+// time to wait for further modifications after the first one,
+// editors often write a file in multiple steps
+constexpr auto settle_time_ms = 100;
+
+void remove_duplicates(std::vector<fs::path>& paths)
+{
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+}
+} // namespace
+
+#ifdef __linux__
+
+namespace
+{
+constexpr auto watch_mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+                            | IN_DELETE_SELF | IN_ONLYDIR;
+
+std::runtime_error inotify_error(const char* msg)
+{
+    return std::runtime_error(std::string(msg) + ": " + std::strerror(errno));
+}
+} // namespace
+
+file_watcher::file_watcher(const std::vector<fs::path>& paths) : paths_(paths), fd_(-1)
+{
+    fd_ = inotify_init1(IN_CLOEXEC);
+    if (fd_ < 0)
+        throw inotify_error("unable to initialize inotify");
+    add_watches();
+}
+
+file_watcher::~file_watcher() noexcept
+{
+    close(fd_);
+}
+
+void file_watcher::add_watches()
+{
+    for (auto& path : paths_)
+        if (fs::is_directory(path))
+            add_watch(path);
+        else
+            add_file_watch(path);
+}
+
+void file_watcher::add_watch(const fs::path& dir)
+{
+    auto wd = inotify_add_watch(fd_, dir.c_str(), watch_mask);
+    if (wd < 0)
+        throw inotify_error(("unable to watch '" + dir.generic_string() + "'").c_str());
+    auto& w     = watches_[wd];
+    w.dir       = dir;
+    w.all_files = true;
+
+    boost::system::error_code ec;
+    for (fs::directory_iterator iter(dir, ec), end; !ec && iter != end; iter.increment(ec))
+        if (iter->status().type() == fs::directory_file)
+            add_watch(iter->path());
+}
+
+void file_watcher::add_file_watch(const fs::path& file)
+{
+    // files can't be watched directly, as editors often replace them with a new one,
+    // so the parent directory is watched, but not its subdirectories
+    auto dir = fs::absolute(file).parent_path();
+    auto wd  = inotify_add_watch(fd_, dir.c_str(), watch_mask);
+    if (wd < 0)
+        throw inotify_error(("unable to watch '" + dir.generic_string() + "'").c_str());
+
+    // the same directory can already be watched, inotify returns the same descriptor then
+    auto& w = watches_[wd];
+    w.dir   = dir;
+    w.files.insert(file.filename().string());
+}
+
+void file_watcher::remove_watches() noexcept
+{
+    // the events of the removed watches are ignored, as the descriptors are unknown now
+    for (auto& pair : watches_)
+        inotify_rm_watch(fd_, pair.first);
+    watches_.clear();
+}
+
+modifications file_watcher::wait()
+{
+    modifications result;
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    auto                        timeout = -1; // block until the first event
+    while (true)
+    {
+        pollfd pfd{fd_, POLLIN, 0};
+        auto   ready = ::poll(&pfd, 1, timeout);
+        if (ready < 0 && errno == EINTR)
+            continue;
+        else if (ready < 0)
+            throw inotify_error("unable to wait for file modifications");
+        else if (ready == 0)
+            // settled
+            break;
+
+        auto size = read(fd_, buffer, sizeof(buffer));
+        if (size < 0 && errno == EINTR)
+            continue;
+        else if (size < 0)
+            throw inotify_error("unable to read file modifications");
+
+        for (auto ptr = buffer; ptr < buffer + size;)
+        {
+            auto& event = *reinterpret_cast<const inotify_event*>(ptr);
+            ptr += sizeof(inotify_event) + event.len;
+
+            if (event.mask & IN_Q_OVERFLOW)
+            {
+                // events have been lost, so directories created in the meantime aren't watched
+                result.unknown = true;
+                remove_watches();
+                add_watches();
+                break;
+            }
+
+            auto dir = watches_.find(event.wd);
+            if (dir == watches_.end())
+                continue;
+            else if (event.mask & IN_IGNORED)
+            {
+                // directory was removed
+                watches_.erase(dir);
+                continue;
+            }
+            else if (event.mask & IN_DELETE_SELF)
+            {
+                // all files in it are gone
+                result.unknown = true;
+                continue;
+            }
+            else if (event.len == 0u)
+                continue;
+            else if (!dir->second.all_files && dir->second.files.count(event.name) == 0u)
+                // a file next to a watched one
+                continue;
+
+            auto path = dir->second.dir / event.name;
+            if (event.mask & IN_ISDIR)
+            {
+                // the files in it are not reported separately
+                if (event.mask & (IN_CREATE | IN_MOVED_TO))
+                    add_watch(path);
+                if (event.mask & (IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO))
+                    result.unknown = true;
+            }
+            else
+                result.files.push_back(std::move(path));
+        }
+
+        if (result.unknown || !result.files.empty())
+            timeout = settle_time_ms;
+    }
+
+    remove_duplicates(result.files);
+    return result;
+}
+
+#else
+
+file_watcher::file_watcher(const std::vector<fs::path>& paths) : paths_(paths), times_(poll()) {}
+
+file_watcher::~file_watcher() noexcept = default;
+
+std::unordered_map<std::string, std::time_t> file_watcher::poll() const
+{
+    std::unordered_map<std::string, std::time_t> result;
+
+    boost::system::error_code ec;
+    for (auto& path : paths_)
+        if (fs::is_directory(path, ec))
+        {
+            for (fs::recursive_directory_iterator iter(path, ec), end; !ec && iter != end;
+                 iter.increment(ec))
+                if (iter->status().type() == fs::regular_file)
+                    result[iter->path().string()] = fs::last_write_time(iter->path(), ec);
+        }
+        else
+            result[path.string()] = fs::last_write_time(path, ec);
+
+    return result;
+}
+
+modifications file_watcher::wait()
+{
+    std::vector<fs::path> result;
+    while (true)
+    {
+        auto interval = result.empty() ? 500 : settle_time_ms;
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+
+        auto times   = poll();
+        auto changed = false;
+        for (auto& pair : times)
+        {
+            auto iter = times_.find(pair.first);
+            if (iter == times_.end() || iter->second != pair.second)
+            {
+                result.push_back(pair.first);
+                changed = true;
+            }
+        }
+        for (auto& pair : times_)
+            if (times.count(pair.first) == 0u)
+            {
+                result.push_back(pair.first);
+                changed = true;
+            }
+        times_ = std::move(times);
+
+        if (!changed && !result.empty())
+            // settled
+            break;
+    }
+
+    // files in moved or deleted directories are reported as well
+    remove_duplicates(result);
+    return modifications{std::move(result), false};
+}
+
+#endif
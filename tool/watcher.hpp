@@ -0,0 +1,70 @@
+// Copyright (C) 2016-2019 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef STANDARDESE_TOOL_WATCHER_HPP_INCLUDED
+#define STANDARDESE_TOOL_WATCHER_HPP_INCLUDED
+
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "filesystem.hpp"
+
+namespace standardese_tool
+{
+// the modifications reported by a file_watcher
+struct modifications
+{
+    // the files created, modified, moved or deleted, without duplicates
+    std::vector<fs::path> files;
+    // set if a directory was moved or deleted or modifications have been lost,
+    // any file may have been modified then
+    bool unknown = false;
+};
+
+// watches files and directories (recursively) for modifications
+// a file is watched through its parent directory, but other files there are ignored
+// uses inotify on Linux and polls the modification times otherwise
+class file_watcher
+{
+public:
+    explicit file_watcher(const std::vector<fs::path>& paths);
+
+    file_watcher(const file_watcher&) = delete;
+    file_watcher& operator=(const file_watcher&) = delete;
+
+    ~file_watcher() noexcept;
+
+    // blocks until one or more files have been created, modified, moved or deleted
+    // modifications happening in short succession are reported together
+    modifications wait();
+
+private:
+    std::vector<fs::path> paths_;
+#ifdef __linux__
+    struct watch
+    {
+        fs::path                        dir;
+        std::unordered_set<std::string> files; // only these files are reported
+        bool                            all_files = false;
+    };
+
+    void add_watches();
+    void add_watch(const fs::path& dir);
+    void add_file_watch(const fs::path& file);
+    void remove_watches() noexcept;
+
+    int                            fd_;
+    std::unordered_map<int, watch> watches_;
+#else
+    std::unordered_map<std::string, std::time_t> poll() const;
+
+    std::unordered_map<std::string, std::time_t> times_;
+#endif
+};
+} // namespace standardese_tool
+
+#endif // STANDARDESE_TOOL_WATCHER_HPP_INCLUDED